@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+    Offline batch renderer for JucetutorialsAudioProcessor.
+
+  ==============================================================================
+*/
+
+#include "BatchRender.h"
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+    using DSP_Order = JucetutorialsAudioProcessor::DSP_Order;
+
+    // Samples read, rendered and written per step. Memory use depends on this
+    // and the channel count only, never on the length of the file.
+    constexpr int samplesPerChunk = 1 << 16;
+
+    struct RenderSettings {
+        int blockSize = 512;
+        bool includeTail = false;
+        juce::File outputDirectory;
+    };
+
+    DSP_Order parseOrder(const juce::String& text) {
+        // Same names as the benchmark prints, separated by ',' or '>'.
+        const juce::StringArray names { "Phase", "Chorus", "Overdrive", "LadderFilter", "GeneralFilter", "Delay" };
+        auto tokens = juce::StringArray::fromTokens(text, ",>", "");
+        DSP_Order order;
+
+        if (tokens.size() != static_cast<int>(order.size()))
+            juce::ConsoleApplication::fail("--order needs each module once: " + names.joinIntoString(","));
+
+        std::uint32_t seen = 0;
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            auto index = names.indexOf(tokens[static_cast<int>(i)].trim(), true);
+
+            if (index < 0 || (seen & (1u << index)) != 0)
+                juce::ConsoleApplication::fail("--order needs each module once: " + names.joinIntoString(","));
+
+            seen |= 1u << index;
+            order[i] = static_cast<DSP_Option>(index);
+        }
+
+        return order;
+    }
+
+    juce::Array<juce::File> getInputFiles(const juce::ArgumentList& args) {
+        juce::Array<juce::File> files;
+
+        // The first argument is the command itself.
+        for (int i = 1; i < args.size(); ++i)
+            if (! args[i].isOption())
+                files.add(args[i].resolveAsFile());
+
+        // Thousands of stems don't fit on a command line, so they can come from a list too.
+        if (args.containsOption("--list")) {
+            auto listFile = args.getExistingFileForOption("--list");
+            juce::StringArray lines;
+            listFile.readLines(lines);
+
+            for (const auto& line : lines)
+                if (line.trim().isNotEmpty())
+                    files.add(listFile.getParentDirectory().getChildFile(line.trim()));
+        }
+
+        if (files.isEmpty())
+            juce::ConsoleApplication::fail("No input files");
+
+        return files;
+    }
+
+    void applyPreset(JucetutorialsAudioProcessor& processor, const juce::ArgumentList& args) {
+        if (args.containsOption("--state")) {
+            juce::MemoryBlock state;
+
+            if (! args.getExistingFileForOption("--state").loadFileAsData(state))
+                juce::ConsoleApplication::fail("Could not read --state file");
+
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            return;
+        }
+
+        if (! args.containsOption("--preset"))
+            return;
+
+        auto name = args.getValueForOption("--preset");
+        juce::StringArray programNames;
+
+        for (int i = 0; i < processor.getNumPrograms(); ++i) {
+            if (processor.getProgramName(i).equalsIgnoreCase(name)) {
+                processor.setCurrentProgram(i);
+                return;
+            }
+
+            programNames.add(processor.getProgramName(i));
+        }
+
+        juce::ConsoleApplication::fail("Unknown --preset: " + name + " (one of " + programNames.joinIntoString(", ") + ")");
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> createReader(juce::AudioFormatManager& formatManager,
+                                                          const juce::File& file,
+                                                          juce::MemoryMappedAudioFormatReader*& mappedReader) {
+        mappedReader = nullptr;
+
+        // Formats that support it are memory-mapped one chunk at a time.
+        if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension())) {
+            if (auto* mapped = format->createMemoryMappedReader(file)) {
+                mappedReader = mapped;
+                return std::unique_ptr<juce::AudioFormatReader>(mapped);
+            }
+        }
+
+        return std::unique_ptr<juce::AudioFormatReader>(formatManager.createReaderFor(file));
+    }
+
+    /** Renders one file into the output directory. Returns an error message, or
+        an empty string and the length of the input in renderedSeconds.
+    */
+    juce::String renderFile(JucetutorialsAudioProcessor& processor,
+                            juce::AudioFormatManager& formatManager,
+                            juce::AudioBuffer<float>& chunk,
+                            const juce::File& input,
+                            const RenderSettings& settings,
+                            double& renderedSeconds) {
+        juce::MemoryMappedAudioFormatReader* mappedReader = nullptr;
+        auto reader = createReader(formatManager, input, mappedReader);
+
+        if (reader == nullptr)
+            return "could not read the file";
+
+        auto sampleRate = reader->sampleRate;
+        auto numInputSamples = reader->lengthInSamples;
+        auto numChannels = chunk.getNumChannels();
+        auto numOutputChannels = juce::jmin(static_cast<int>(reader->numChannels), numChannels);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, settings.blockSize);
+        processor.prepareToPlay(sampleRate, settings.blockSize);
+
+        // Render past the end by the latency, so the output lines up with the input,
+        // and by the tail if asked, so delays and reverbs ring out.
+        juce::int64 latency = processor.getLatencySamples();
+        auto tail = settings.includeTail ? static_cast<juce::int64>(std::ceil(processor.getTailLengthSeconds() * sampleRate)) : 0;
+        auto numSamplesToRender = numInputSamples + latency + tail;
+
+        auto outputFile = settings.outputDirectory.getChildFile(input.getFileNameWithoutExtension() + ".wav");
+        outputFile.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+
+        if (! stream->openedOk())
+            return "could not create " + outputFile.getFullPathName();
+
+        juce::WavAudioFormat wav;
+        auto bitsPerSample = wav.getPossibleBitDepths().contains(static_cast<int>(reader->bitsPerSample)) ? static_cast<int>(reader->bitsPerSample) : 24;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, static_cast<unsigned int>(numOutputChannels), bitsPerSample, {}, 0));
+
+        if (writer == nullptr)
+            return "could not write " + outputFile.getFullPathName();
+
+        stream.release();   // now owned by the writer
+
+        juce::MidiBuffer midi;
+
+        for (juce::int64 position = 0; position < numSamplesToRender; position += samplesPerChunk) {
+            auto numSamples = static_cast<int>(juce::jmin<juce::int64>(samplesPerChunk, numSamplesToRender - position));
+            auto numToRead = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, numInputSamples - position));
+
+            chunk.clear();
+
+            if (numToRead > 0) {
+                if (mappedReader != nullptr && ! mappedReader->mapSectionOfFile({ position, position + numToRead }))
+                    return "could not map the file";
+
+                reader->read(&chunk, 0, numToRead, position, true, numChannels > 1);
+
+                for (int ch = static_cast<int>(reader->numChannels); ch < numChannels; ++ch)
+                    chunk.copyFrom(ch, 0, chunk, 0, 0, numToRead);
+            }
+
+            for (int start = 0; start < numSamples; start += settings.blockSize) {
+                juce::AudioBuffer<float> block(chunk.getArrayOfWritePointers(), numChannels, start, juce::jmin(settings.blockSize, numSamples - start));
+                processor.processBlock(block, midi);
+            }
+
+            // The first latency samples are the chain's delay, not output.
+            auto skip = static_cast<int>(juce::jlimit<juce::int64>(0, numSamples, latency - position));
+
+            if (skip < numSamples && ! writer->writeFromAudioSampleBuffer(chunk, skip, numSamples - skip))
+                return "could not write " + outputFile.getFullPathName();
+        }
+
+        processor.releaseResources();
+        renderedSeconds = static_cast<double>(numInputSamples) / sampleRate;
+        return {};
+    }
+}
+
+//==============================================================================
+void runBatchRender(const juce::ArgumentList& args) {
+    auto files = getInputFiles(args);
+    auto numWorkers = args.containsOption("--threads") ? args.getValueForOption("--threads").getIntValue() : juce::SystemStats::getNumCpus();
+    numWorkers = juce::jmin(numWorkers, files.size());
+
+    RenderSettings settings;
+    settings.blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 512;
+    settings.includeTail = args.containsOption("--tail");
+    settings.outputDirectory = args.containsOption("--output-dir") ? args.getFileForOption("--output-dir") : juce::File();
+
+    if (numWorkers <= 0 || settings.blockSize <= 0)
+        juce::ConsoleApplication::fail("--threads and --block-size must be positive");
+
+    if (settings.outputDirectory == juce::File() || ! settings.outputDirectory.createDirectory())
+        juce::ConsoleApplication::fail("Missing or unusable --output-dir");
+
+    // Outputs are named after their inputs, so two inputs mustn't share a name.
+    juce::StringArray outputNames;
+
+    for (const auto& file : files) {
+        if (outputNames.contains(file.getFileNameWithoutExtension(), true))
+            juce::ConsoleApplication::fail("Two inputs would both render to " + file.getFileNameWithoutExtension() + ".wav");
+
+        outputNames.add(file.getFileNameWithoutExtension());
+    }
+
+    std::optional<DSP_Order> order;
+
+    if (args.containsOption("--order"))
+        order = parseOrder(args.getValueForOption("--order"));
+
+    // One processor per worker, set up here and reused for every file that
+    // worker renders, so the parameter tree and programs are built only once.
+    std::vector<std::unique_ptr<JucetutorialsAudioProcessor>> processors;
+
+    for (int i = 0; i < numWorkers; ++i) {
+        auto processor = std::make_unique<JucetutorialsAudioProcessor>();
+        processor->setNonRealtime(true);
+        applyPreset(*processor, args);
+
+        if (order.has_value())
+            processor->setDSPOrder(*order);
+
+        processors.push_back(std::move(processor));
+    }
+
+    std::atomic<int> nextFile { 0 };
+    std::atomic<double> totalRenderedSeconds { 0.0 };
+    std::vector<juce::String> errors(static_cast<size_t>(files.size()));
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::ThreadPool pool(numWorkers);
+
+        for (auto& processor : processors) {
+            pool.addJob([&, processor = processor.get()] {
+                juce::AudioFormatManager formatManager;
+                formatManager.registerBasicFormats();
+
+                auto numChannels = juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+                juce::AudioBuffer<float> chunk(numChannels, samplesPerChunk);
+
+                // Idle workers take the next file, so a few long files can't hold up the rest.
+                for (auto index = nextFile++; index < files.size(); index = nextFile++) {
+                    double renderedSeconds = 0.0;
+                    auto error = renderFile(*processor, formatManager, chunk, files[index], settings, renderedSeconds);
+
+                    if (error.isNotEmpty())
+                        errors[static_cast<size_t>(index)] = error;
+                    else
+                        totalRenderedSeconds.fetch_add(renderedSeconds);
+                }
+            });
+        }
+
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+
+    auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    int numFailed = 0;
+
+    for (int i = 0; i < files.size(); ++i) {
+        if (errors[static_cast<size_t>(i)].isNotEmpty()) {
+            std::cerr << files[i].getFullPathName() << ": " << errors[static_cast<size_t>(i)] << std::endl;
+            ++numFailed;
+        }
+    }
+
+    std::cout << files.size() - numFailed << " of " << files.size() << " files on " << numWorkers << " threads  "
+              << juce::String(totalRenderedSeconds.load(), 1) << " s of audio in " << juce::String(wallSeconds, 2) << " s  "
+              << juce::String(totalRenderedSeconds.load() / juce::jmax(wallSeconds, 1.0e-9), 1) << " realtime s/wall s"
+              << std::endl;
+
+    if (numFailed > 0)
+        juce::ConsoleApplication::fail(juce::String(numFailed) + " files failed");
+}
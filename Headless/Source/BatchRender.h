@@ -0,0 +1,17 @@
+/*
+  ==============================================================================
+
+    Offline batch renderer for JucetutorialsAudioProcessor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Renders every input file through the processor with one preset and
+    DSP_Order, on a pool of worker threads that each own a processor, and
+    reports the aggregate throughput in realtime seconds per wall second.
+*/
+void runBatchRender (const juce::ArgumentList& args);
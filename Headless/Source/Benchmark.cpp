@@ -0,0 +1,1084 @@
+/*
+  ==============================================================================
+
+    Offline render benchmark for JucetutorialsAudioProcessor.
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/DSP/CrossoverSplitter.h"
+#include "../../Source/DSP/MultiChannelBiquad.h"
+#include "../../Source/DSP/Overdrive.h"
+
+namespace
+{
+    using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+    using DSP_Order = JucetutorialsAudioProcessor::DSP_Order;
+    using ChainDispatch = JucetutorialsAudioProcessor::ChainDispatch;
+
+    struct BenchmarkPreset {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    std::vector<BenchmarkPreset> getBenchmarkPresets() {
+        return {
+            { "Default", {} },
+            { "Subtle", {
+                { "Phaser Mix %", 0.3f },
+                { "Chorus Mix %", 0.3f },
+                { "Overdrive Saturation", 4.f },
+                { "Ladder Filter Cutoff Hz", 8000.f },
+                { "General Filter Gain", 3.f },
+                { "Delay Mix %", 0.1f },
+            } },
+            { "Heavy", {
+                { "Phaser Depth %", 1.f },
+                { "Phaser Feedback %", 0.8f },
+                { "Phaser Mix %", 1.f },
+                { "Phaser LFO Phase", 1.f },
+                { "Chorus Depth %", 0.8f },
+                { "Chorus Feedback %", 0.7f },
+                { "Chorus Mix %", 1.f },
+                { "Chorus LFO Phase", 1.f },
+                { "Overdrive Saturation", 40.f },
+                { "Ladder Filter Mode", 3.f },
+                { "Ladder Filter Cutoff Hz", 800.f },
+                { "Ladder Filter Resonance", 0.8f },
+                { "General Filter Quality", 4.f },
+                { "General Filter Gain", 12.f },
+                { "Delay Sync", 1.f },
+                { "Delay Feedback %", 0.9f },
+                { "Delay Mix %", 0.5f },
+                { "Mod 1 Source", 1.f },
+                { "Mod 1 Target", 14.f },
+                { "Mod 1 Depth", 0.3f },
+            } },
+        };
+    }
+
+    juce::String getOptionName(DSP_Option option) {
+        switch (option) {
+        case DSP_Option::Phase:         return "Phase";
+        case DSP_Option::Chorus:        return "Chorus";
+        case DSP_Option::Overdrive:     return "Overdrive";
+        case DSP_Option::LadderFilter:  return "LadderFilter";
+        case DSP_Option::GeneralFilter: return "GeneralFilter";
+        case DSP_Option::Delay:         return "Delay";
+        case DSP_Option::END_OF_LIST:   break;
+        }
+
+        jassertfalse;
+        return {};
+    }
+
+    juce::String getOrderName(const DSP_Order& order) {
+        juce::StringArray names;
+
+        for (auto option : order)
+            names.add(getOptionName(option));
+
+        return names.joinIntoString(">");
+    }
+
+    std::vector<DSP_Order> getOrders(bool allPermutations) {
+        DSP_Order order;
+
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<DSP_Option>(i);
+
+        std::vector<DSP_Order> orders;
+
+        do {
+            orders.push_back(order);
+        } while (allPermutations && std::next_permutation(order.begin(), order.end()));
+
+        return orders;
+    }
+
+    std::vector<DSP_Order> getOrders(const juce::String& text) {
+        if (text == "all")
+            return getOrders(true);
+
+        if (text.isNotEmpty() && text != "default")
+            juce::ConsoleApplication::fail("Unknown --orders: " + text);
+
+        return getOrders(false);
+    }
+
+    juce::String getDispatchName(ChainDispatch dispatch) {
+        return dispatch == ChainDispatch::Specialized ? "specialized" : "pointers";
+    }
+
+    std::vector<ChainDispatch> getDispatches(const juce::String& text) {
+        if (text == "specialized")
+            return { ChainDispatch::Specialized };
+
+        if (text == "pointers")
+            return { ChainDispatch::PointerArray };
+
+        if (text.isNotEmpty() && text != "both")
+            juce::ConsoleApplication::fail("Unknown --dispatch: " + text);
+
+        return { ChainDispatch::Specialized, ChainDispatch::PointerArray };
+    }
+
+    juce::StringArray getListOption(const juce::ArgumentList& args, juce::StringRef option, juce::StringRef defaultValue) {
+        auto text = args.containsOption(option) ? args.getValueForOption(option) : juce::String(defaultValue);
+        return juce::StringArray::fromTokens(text, ",", "");
+    }
+
+    juce::AudioBuffer<float> makeTestSignal(int numChannels, double sampleRate) {
+        // Ten seconds of detuned saw-ish tones plus noise, looped by the render loop.
+        auto numSamples = static_cast<int>(sampleRate * 10.0);
+        juce::AudioBuffer<float> signal(numChannels, numSamples);
+        juce::Random random(42);
+
+        for (int ch = 0; ch < numChannels; ++ch) {
+            auto* data = signal.getWritePointer(ch);
+            auto phaseInc = juce::MathConstants<double>::twoPi * (110.0 + ch * 0.7) / sampleRate;
+
+            for (int i = 0; i < numSamples; ++i) {
+                auto phase = phaseInc * i;
+                auto tone = std::sin(phase) + 0.5 * std::sin(2.0 * phase) + 0.33 * std::sin(3.0 * phase);
+                data[i] = static_cast<float>(0.2 * tone) + 0.05f * (random.nextFloat() * 2.f - 1.f);
+            }
+        }
+
+        return signal;
+    }
+
+    juce::AudioBuffer<float> loadInput(const juce::File& file, int numChannels) {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+        if (reader == nullptr)
+            juce::ConsoleApplication::fail("Could not read input file: " + file.getFullPathName());
+
+        auto numSamples = static_cast<int>(reader->lengthInSamples);
+        juce::AudioBuffer<float> input(numChannels, numSamples);
+        reader->read(&input, 0, numSamples, 0, true, numChannels > 1);
+
+        return input;
+    }
+
+    void applyPreset(JucetutorialsAudioProcessor& processor, const BenchmarkPreset& preset) {
+        for (const auto& [paramID, value] : preset.values) {
+            auto* param = processor.apvts.getParameter(paramID);
+
+            if (param == nullptr)
+                juce::ConsoleApplication::fail("Unknown parameter in preset " + preset.name + ": " + paramID);
+
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        }
+    }
+
+    // Resident set size from /proc where there is one, otherwise 0.
+    juce::int64 getResidentBytes() {
+        juce::StringArray lines;
+        juce::File("/proc/self/status").readLines(lines);
+
+        for (const auto& line : lines)
+            if (line.startsWith("VmRSS:"))
+                return line.fromFirstOccurrenceOf(":", false, false).trim().getLargeIntValue() * 1024;
+
+        return 0;
+    }
+
+    juce::String formatBytes(juce::int64 bytes) {
+        return juce::String(static_cast<double>(bytes) / 1024.0, 1) + " KB";
+    }
+
+    void writeResults(const juce::ArgumentList& args,
+                      const juce::String& benchmark,
+                      const juce::Array<juce::var>& results,
+                      const juce::NamedValueSet& metadata = {}) {
+        juce::DynamicObject::Ptr root = new juce::DynamicObject();
+        root->setProperty("schema", 1);
+        root->setProperty("benchmark", benchmark);
+        root->setProperty("plugin", JucePlugin_Name);
+        root->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("numCpus", juce::SystemStats::getNumCpus());
+
+        for (const auto& value : metadata)
+            root->setProperty(value.name, value.value);
+
+        root->setProperty("results", results);
+
+        auto outputFile = args.getFileForOption("--output");
+
+        if (! outputFile.replaceWithText(juce::JSON::toString(juce::var(root.get()))))
+            juce::ConsoleApplication::fail("Could not write " + outputFile.getFullPathName());
+    }
+
+    struct BenchmarkResult {
+        double sampleRate = 0;
+        int blockSize = 0, numChannels = 0;
+        juce::String order, preset, dispatch;
+        int minimumSubBlockSize = 0;
+        bool automated = false;
+        double nsPerSample = 0, nsPerChannelSample = 0, realtimeFactor = 0;
+        double p50Micros = 0, p90Micros = 0, p99Micros = 0, maxMicros = 0;
+
+        juce::var toVar() const {
+            juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+            obj->setProperty("sampleRate", sampleRate);
+            obj->setProperty("blockSize", blockSize);
+            obj->setProperty("numChannels", numChannels);
+            obj->setProperty("order", order);
+            obj->setProperty("preset", preset);
+            obj->setProperty("dispatch", dispatch);
+            obj->setProperty("minimumSubBlockSize", minimumSubBlockSize);
+            obj->setProperty("automated", automated);
+            obj->setProperty("nsPerSample", nsPerSample);
+            obj->setProperty("nsPerChannelSample", nsPerChannelSample);
+            obj->setProperty("realtimeFactor", realtimeFactor);
+            obj->setProperty("blockP50Us", p50Micros);
+            obj->setProperty("blockP90Us", p90Micros);
+            obj->setProperty("blockP99Us", p99Micros);
+            obj->setProperty("blockMaxUs", maxMicros);
+            return juce::var(obj.get());
+        }
+    };
+
+    BenchmarkResult runCase(const juce::AudioBuffer<float>& source,
+                            double sampleRate,
+                            int blockSize,
+                            int numBusChannels,
+                            const DSP_Order& order,
+                            const BenchmarkPreset& preset,
+                            ChainDispatch dispatch,
+                            int minimumSubBlockSize,
+                            bool automate,
+                            double seconds) {
+        JucetutorialsAudioProcessor processor;
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+
+        if (! processor.setBusesLayout(layout))
+            juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numBusChannels));
+
+        processor.setChainDispatch(dispatch);
+        processor.setMinimumSubBlockSize(minimumSubBlockSize);
+        applyPreset(processor, preset);
+        processor.setDSPOrder(order);
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        auto numChannels = juce::jmax(processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels());
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+
+        int readPosition = 0;
+        auto fillBlock = [&] {
+            for (int done = 0; done < blockSize;) {
+                auto num = juce::jmin(blockSize - done, source.getNumSamples() - readPosition);
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    buffer.copyFrom(ch, done, source, ch % source.getNumChannels(), readPosition, num);
+
+                done += num;
+                readPosition = (readPosition + num) % source.getNumSamples();
+            }
+        };
+
+        // With --automate, sweep the general filter like a host automation
+        // lane, so every block has a parameter change to split at.
+        auto* automatedParameter = processor.apvts.getParameter("General Filter Freq Hz");
+        jassert(automatedParameter != nullptr);
+        int numBlocksDone = 0;
+
+        auto automateBlock = [&] {
+            if (! automate)
+                return;
+
+            auto phase = std::fmod(static_cast<double>(numBlocksDone++) * blockSize / sampleRate * 0.5, 1.0);
+            automatedParameter->setValueNotifyingHost(static_cast<float>(1.0 - std::abs(2.0 * phase - 1.0)));
+        };
+
+        // Let smoothers settle and caches warm up before measuring.
+        for (int i = 0; i < 16; ++i) {
+            fillBlock();
+            automateBlock();
+            processor.processBlock(buffer, midi);
+        }
+
+        auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate) / blockSize);
+        std::vector<double> blockSeconds;
+        blockSeconds.reserve(static_cast<size_t>(numBlocks));
+
+        for (int i = 0; i < numBlocks; ++i) {
+            fillBlock();
+            automateBlock();
+
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            auto end = juce::Time::getHighResolutionTicks();
+
+            blockSeconds.push_back(juce::Time::highResolutionTicksToSeconds(end - start));
+        }
+
+        processor.releaseResources();
+
+        auto totalSeconds = std::accumulate(blockSeconds.begin(), blockSeconds.end(), 0.0);
+        auto totalSamples = static_cast<double>(numBlocks) * blockSize;
+        std::sort(blockSeconds.begin(), blockSeconds.end());
+
+        auto percentileMicros = [&](double p) {
+            auto index = static_cast<size_t>(std::round(p * static_cast<double>(blockSeconds.size() - 1)));
+            return blockSeconds[index] * 1.0e6;
+        };
+
+        BenchmarkResult result;
+        result.sampleRate = sampleRate;
+        result.blockSize = blockSize;
+        result.numChannels = numChannels;
+        result.order = getOrderName(order);
+        result.preset = preset.name;
+        result.dispatch = getDispatchName(dispatch);
+        result.minimumSubBlockSize = minimumSubBlockSize;
+        result.automated = automate;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+        result.nsPerChannelSample = result.nsPerSample / numChannels;
+        result.realtimeFactor = (totalSamples / sampleRate) / juce::jmax(totalSeconds, 1.0e-12);
+        result.p50Micros = percentileMicros(0.5);
+        result.p90Micros = percentileMicros(0.9);
+        result.p99Micros = percentileMicros(0.99);
+        result.maxMicros = blockSeconds.back() * 1.0e6;
+        return result;
+    }
+}
+
+//==============================================================================
+void runBenchmark(const juce::ArgumentList& args) {
+    auto sampleRates = getListOption(args, "--sample-rates", "44100,48000,96000");
+    auto blockSizes = getListOption(args, "--block-sizes", "64,256,1024");
+    auto channelCounts = getListOption(args, "--channels", "2");
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+    auto orders = getOrders(args.getValueForOption("--orders"));
+    auto presets = getBenchmarkPresets();
+    auto dispatches = getDispatches(args.getValueForOption("--dispatch"));
+    auto minimumSubBlockSize = args.containsOption("--min-sub-block") ? args.getValueForOption("--min-sub-block").getIntValue() : 64;
+    auto automate = args.containsOption("--automate");
+
+    if (seconds <= 0.0)
+        juce::ConsoleApplication::fail("--seconds must be positive");
+
+    if (minimumSubBlockSize <= 0)
+        juce::ConsoleApplication::fail("--min-sub-block must be positive");
+
+    const int numChannels = 2;
+    std::optional<juce::AudioBuffer<float>> fileInput;
+
+    if (args.containsOption("--input"))
+        fileInput = loadInput(args.getExistingFileForOption("--input"), numChannels);
+
+    juce::Array<juce::var> results;
+
+    for (const auto& rateText : sampleRates) {
+        auto sampleRate = rateText.getDoubleValue();
+        auto source = fileInput.has_value() ? *fileInput : makeTestSignal(numChannels, sampleRate);
+
+        for (const auto& blockText : blockSizes) {
+            auto blockSize = blockText.getIntValue();
+
+            if (sampleRate <= 0.0 || blockSize <= 0)
+                juce::ConsoleApplication::fail("Invalid sample rate or block size: " + rateText + " / " + blockText);
+
+            for (const auto& channelText : channelCounts) {
+                auto numBusChannels = channelText.getIntValue();
+
+                if (! juce::isPositiveAndNotGreaterThan(numBusChannels, JucetutorialsAudioProcessor::maxNumChannels))
+                    juce::ConsoleApplication::fail("Invalid channel count: " + channelText);
+
+                for (const auto& preset : presets) {
+                    for (const auto& order : orders) {
+                        for (auto dispatch : dispatches) {
+                            auto result = runCase(source, sampleRate, blockSize, numBusChannels, order, preset, dispatch, minimumSubBlockSize, automate, seconds);
+
+                            std::cout << juce::String(sampleRate, 0) << " Hz  "
+                                      << juce::String(blockSize).paddedLeft(' ', 5) << "  "
+                                      << juce::String(numBusChannels).paddedLeft(' ', 2) << " ch  "
+                                      << preset.name.paddedRight(' ', 8) << "  "
+                                      << result.dispatch.paddedRight(' ', 12)
+                                      << result.order.paddedRight(' ', 50)
+                                      << juce::String(result.nsPerSample, 2).paddedLeft(' ', 9) << " ns/sample  "
+                                      << juce::String(result.nsPerChannelSample, 2).paddedLeft(' ', 8) << " ns/ch-sample  "
+                                      << juce::String(result.realtimeFactor, 1).paddedLeft(' ', 8) << "x RT  "
+                                      << "p50 " << juce::String(result.p50Micros, 1) << " us  "
+                                      << "p99 " << juce::String(result.p99Micros, 1) << " us  "
+                                      << "max " << juce::String(result.maxMicros, 1) << " us"
+                                      << std::endl;
+
+                            results.add(result.toVar());
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (args.containsOption("--output")) {
+        juce::NamedValueSet metadata;
+        metadata.set("input", fileInput.has_value() ? args.getValueForOption("--input") : juce::String("generated"));
+        metadata.set("secondsPerCase", seconds);
+        writeResults(args, "chain", results, metadata);
+    }
+}
+
+//==============================================================================
+void runBiquadBenchmark(const juce::ArgumentList& args) {
+    using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+    auto channelCounts = getListOption(args, "--channels", "1,2,4,6,8,16");
+
+    std::vector<std::pair<juce::String, std::array<float, 6>>> coefficientSets {
+        { "Peak",     Coefficients::makePeakFilter(sampleRate, 1000.f, 2.f, 2.f) },
+        { "Bandpass", Coefficients::makeBandPass(sampleRate, 200.f, 0.7f) },
+        { "Notch",    Coefficients::makeNotch(sampleRate, 5000.f, 4.f) },
+        { "Allpass",  Coefficients::makeAllPass(sampleRate, 800.f, 1.f) },
+    };
+
+    juce::Array<juce::var> results;
+    juce::Random random(42);
+
+    for (const auto& channelText : channelCounts) {
+        auto numChannels = channelText.getIntValue();
+
+        if (numChannels <= 0)
+            juce::ConsoleApplication::fail("Invalid channel count: " + channelText);
+
+        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+        juce::dsp::ProcessSpec monoSpec { sampleRate, static_cast<juce::uint32>(blockSize), 1 };
+
+        juce::AudioBuffer<float> input(numChannels, blockSize), simdBuffer(numChannels, blockSize), scalarBuffer(numChannels, blockSize);
+
+        for (const auto& [name, coefficients] : coefficientSets) {
+            MultiChannelBiquad simd;
+            simd.prepare(spec);
+            simd.setCoefficients(coefficients);
+
+            juce::OwnedArray<juce::dsp::IIR::Filter<float>> scalar;
+
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto* filter = scalar.add(new juce::dsp::IIR::Filter<float>());
+                filter->coefficients = new juce::dsp::IIR::Coefficients<float>(coefficients[0], coefficients[1], coefficients[2],
+                                                                               coefficients[3], coefficients[4], coefficients[5]);
+                filter->prepare(monoSpec);
+            }
+
+            auto processSimd = [&] {
+                juce::dsp::AudioBlock<float> block(simdBuffer);
+                simd.process(juce::dsp::ProcessContextReplacing<float>(block));
+            };
+
+            auto processScalar = [&] {
+                juce::dsp::AudioBlock<float> block(scalarBuffer);
+
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    auto channelBlock = block.getSingleChannelBlock(static_cast<size_t>(ch));
+                    scalar[ch]->process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
+                }
+            };
+
+            // Correctness: both paths must agree on random input across many blocks.
+            float maxError = 0.f;
+
+            for (int b = 0; b < 64; ++b) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        input.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+
+                simdBuffer.makeCopyOf(input, true);
+                scalarBuffer.makeCopyOf(input, true);
+                processSimd();
+                processScalar();
+
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        maxError = juce::jmax(maxError, std::abs(simdBuffer.getSample(ch, i) - scalarBuffer.getSample(ch, i)));
+            }
+
+            if (maxError > 1.0e-4f)
+                juce::ConsoleApplication::fail("MultiChannelBiquad differs from IIR::Filter (" + name + ", "
+                                               + juce::String(numChannels) + " ch): max error " + juce::String(maxError));
+
+            // Throughput: filtered in place over and over, a boosting filter
+            // would run away and the others decay into denormals, so every
+            // block starts again from the last block of noise. Both paths pay
+            // for the same copy.
+            auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate) / blockSize);
+
+            auto timeBlocks = [&](juce::AudioBuffer<float>& buffer, auto&& processBlock) {
+                juce::ScopedNoDenormals noDenormals;
+                auto start = juce::Time::getHighResolutionTicks();
+
+                for (int b = 0; b < numBlocks; ++b) {
+                    for (int ch = 0; ch < numChannels; ++ch)
+                        buffer.copyFrom(ch, 0, input, ch, 0, blockSize);
+
+                    processBlock();
+                }
+
+                auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                return elapsed * 1.0e9 / (static_cast<double>(numBlocks) * blockSize * numChannels);
+            };
+
+            auto simdNs = timeBlocks(simdBuffer, processSimd);
+            auto scalarNs = timeBlocks(scalarBuffer, processScalar);
+
+            std::cout << juce::String(numChannels).paddedLeft(' ', 3) << " ch  "
+                      << name.paddedRight(' ', 9)
+                      << "simd " << juce::String(simdNs, 2).paddedLeft(' ', 7) << " ns/ch-sample  "
+                      << "scalar " << juce::String(scalarNs, 2).paddedLeft(' ', 7) << " ns/ch-sample  "
+                      << "speedup " << juce::String(scalarNs / juce::jmax(simdNs, 1.0e-12), 2) << "x  "
+                      << "max error " << juce::String(maxError)
+                      << std::endl;
+
+            juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+            obj->setProperty("channels", numChannels);
+            obj->setProperty("filter", name);
+            obj->setProperty("simdNsPerChannelSample", simdNs);
+            obj->setProperty("scalarNsPerChannelSample", scalarNs);
+            obj->setProperty("maxError", maxError);
+            results.add(juce::var(obj.get()));
+        }
+    }
+
+    if (args.containsOption("--output"))
+        writeResults(args, "biquad", results);
+}
+
+//==============================================================================
+void runCrossoverBenchmark(const juce::ArgumentList& args) {
+    using LinkwitzRiley = juce::dsp::LinkwitzRileyFilter<float>;
+    using FilterType = juce::dsp::LinkwitzRileyFilterType;
+
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+    auto channelCounts = getListOption(args, "--channels", "1,2,8");
+    const std::array<float, CrossoverSplitter::numCrossovers> crossovers { 200.f, 1000.f, 5000.f };
+
+    juce::Array<juce::var> results;
+    juce::Random random(42);
+
+    for (const auto& channelText : channelCounts) {
+        auto numChannels = channelText.getIntValue();
+
+        if (numChannels <= 0)
+            juce::ConsoleApplication::fail("Invalid channel count: " + channelText);
+
+        juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+        auto numBlockChannels = static_cast<size_t>(numChannels);
+
+        for (size_t numBands = 2; numBands <= CrossoverSplitter::maxBands; ++numBands) {
+            auto numBandChannels = numChannels * static_cast<int>(numBands);
+
+            CrossoverSplitter simd;
+            simd.prepare(spec);
+            simd.setCrossovers(numBands, crossovers);
+
+            // The reference is SimpleMultiBandComp's tree: each crossover splits
+            // the highest band, and an allpass per lower band keeps them in phase.
+            std::vector<LinkwitzRiley> lowPass(numBands - 1), highPass(numBands - 1);
+            std::vector<std::vector<LinkwitzRiley>> allPass(numBands - 1);
+
+            for (size_t k = 0; k + 1 < numBands; ++k) {
+                allPass[k].resize(k);
+
+                auto setUp = [&](LinkwitzRiley& filter, FilterType type) {
+                    filter.setType(type);
+                    filter.setCutoffFrequency(crossovers[k]);
+                    filter.prepare(spec);
+                };
+
+                setUp(lowPass[k], FilterType::lowpass);
+                setUp(highPass[k], FilterType::highpass);
+
+                for (auto& filter : allPass[k])
+                    setUp(filter, FilterType::allpass);
+            }
+
+            juce::AudioBuffer<float> input(numChannels, blockSize), simdBuffer(numBandChannels, blockSize), scalarBuffer(numBandChannels, blockSize);
+
+            auto processSimd = [&] {
+                simd.process(juce::dsp::AudioBlock<float>(input), juce::dsp::AudioBlock<float>(simdBuffer));
+            };
+
+            auto processScalar = [&] {
+                juce::dsp::AudioBlock<float> block(scalarBuffer);
+                auto getBand = [&](size_t band) { return block.getSubsetChannelBlock(band * numBlockChannels, numBlockChannels); };
+
+                // The last band holds what's left above the crossovers so far.
+                auto rest = getBand(numBands - 1);
+                rest.copyFrom(juce::dsp::AudioBlock<float>(input));
+
+                for (size_t k = 0; k + 1 < numBands; ++k) {
+                    auto band = getBand(k);
+                    band.copyFrom(rest);
+                    lowPass[k].process(juce::dsp::ProcessContextReplacing<float>(band));
+                    highPass[k].process(juce::dsp::ProcessContextReplacing<float>(rest));
+
+                    for (size_t lower = 0; lower < k; ++lower) {
+                        auto lowerBand = getBand(lower);
+                        allPass[k][lower].process(juce::dsp::ProcessContextReplacing<float>(lowerBand));
+                    }
+                }
+            };
+
+            // Correctness: both paths must agree on random input across many blocks.
+            float maxError = 0.f;
+
+            for (int b = 0; b < 64; ++b) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        input.setSample(ch, i, random.nextFloat() * 2.f - 1.f);
+
+                processSimd();
+                processScalar();
+
+                for (int ch = 0; ch < numBandChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        maxError = juce::jmax(maxError, std::abs(simdBuffer.getSample(ch, i) - scalarBuffer.getSample(ch, i)));
+            }
+
+            // The reference runs TPT filters rather than biquads, so allow for rounding.
+            if (maxError > 1.0e-3f)
+                juce::ConsoleApplication::fail("CrossoverSplitter differs from LinkwitzRileyFilter (" + juce::String(numBands) + " bands, "
+                                               + juce::String(numChannels) + " ch): max error " + juce::String(maxError));
+
+            auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate) / blockSize);
+
+            auto timeBlocks = [&](auto&& processBlock) {
+                auto start = juce::Time::getHighResolutionTicks();
+
+                for (int b = 0; b < numBlocks; ++b)
+                    processBlock();
+
+                auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+                return elapsed * 1.0e9 / (static_cast<double>(numBlocks) * blockSize * numChannels);
+            };
+
+            auto simdNs = timeBlocks(processSimd);
+            auto scalarNs = timeBlocks(processScalar);
+
+            std::cout << juce::String(numChannels).paddedLeft(' ', 3) << " ch  "
+                      << juce::String(numBands) << " bands  "
+                      << "simd " << juce::String(simdNs, 2).paddedLeft(' ', 7) << " ns/ch-sample  "
+                      << "scalar " << juce::String(scalarNs, 2).paddedLeft(' ', 7) << " ns/ch-sample  "
+                      << "speedup " << juce::String(scalarNs / juce::jmax(simdNs, 1.0e-12), 2) << "x  "
+                      << "max error " << juce::String(maxError)
+                      << std::endl;
+
+            juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+            obj->setProperty("channels", numChannels);
+            obj->setProperty("bands", static_cast<int>(numBands));
+            obj->setProperty("simdNsPerChannelSample", simdNs);
+            obj->setProperty("scalarNsPerChannelSample", scalarNs);
+            obj->setProperty("maxError", maxError);
+            results.add(juce::var(obj.get()));
+        }
+    }
+
+    if (args.containsOption("--output"))
+        writeResults(args, "crossover", results);
+}
+
+//==============================================================================
+void runOverdriveBenchmark(const juce::ArgumentList& args) {
+    const double sampleRate = 48000.0;
+    const int blockSize = 512;
+    const int numChannels = 2;
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 2.0;
+    auto drive = args.containsOption("--drive") ? args.getValueForOption("--drive").getFloatValue() : 8.f;
+
+    const std::array<std::pair<Overdrive::Kernel, const char*>, 4> kernels {{
+        { Overdrive::Kernel::Tanh,         "Tanh" },
+        { Overdrive::Kernel::RationalTanh, "Rational" },
+        { Overdrive::Kernel::SoftClip,     "SoftClip" },
+        { Overdrive::Kernel::Table,        "Table" },
+    }};
+
+    // A tone centred on an FFT bin, so its harmonics land exactly on bins and
+    // anything else in the spectrum is aliasing folded back from above Nyquist.
+    const int fftOrder = 14;
+    const int fftSize = 1 << fftOrder;
+    const int toneBin = juce::roundToInt(4997.0 * fftSize / sampleRate);
+    const double toneHz = toneBin * sampleRate / fftSize;
+
+    juce::dsp::FFT fft(fftOrder);
+    juce::dsp::WindowingFunction<float> window(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false);
+    std::vector<float> fftData(static_cast<size_t>(fftSize) * 2);
+
+    juce::Array<juce::var> results;
+    juce::Random random(42);
+
+    for (const auto& [kernel, kernelName] : kernels) {
+        for (size_t order = 0; order <= Overdrive::maxOversamplingOrder; ++order) {
+            juce::dsp::ProcessSpec spec { sampleRate, static_cast<juce::uint32>(blockSize), static_cast<juce::uint32>(numChannels) };
+
+            Overdrive overdrive;
+            overdrive.prepare(spec);
+            overdrive.setDrive(drive);
+            overdrive.setKernel(kernel);
+            overdrive.setOversamplingOrder(order);
+            overdrive.reset();
+
+            juce::AudioBuffer<float> buffer(numChannels, blockSize);
+            juce::dsp::AudioBlock<float> block(buffer);
+
+            // Aliasing: render the tone and keep the last fftSize samples of the left channel.
+            const int numToneBlocks = fftSize / blockSize + 8;
+            std::fill(fftData.begin(), fftData.end(), 0.f);
+
+            for (int b = 0; b < numToneBlocks; ++b) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(ch, i, 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * toneHz
+                                                                                   * (b * blockSize + i) / sampleRate)));
+
+                overdrive.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+                auto firstKept = (numToneBlocks - b - 1) * blockSize;
+
+                if (firstKept < fftSize)
+                    std::copy(buffer.getReadPointer(0), buffer.getReadPointer(0) + blockSize,
+                              fftData.begin() + (fftSize - blockSize - firstKept));
+            }
+
+            window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+            fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+            double harmonicPower = 0.0, otherPower = 0.0;
+
+            for (int bin = 3; bin <= fftSize / 2; ++bin) {
+                auto power = static_cast<double>(fftData[static_cast<size_t>(bin)]) * fftData[static_cast<size_t>(bin)];
+                auto distanceToHarmonic = std::abs(bin - toneBin * juce::roundToInt(static_cast<double>(bin) / toneBin));
+
+                if (distanceToHarmonic <= 2)
+                    harmonicPower += power;
+                else
+                    otherPower += power;
+            }
+
+            auto aliasingDb = 10.0 * std::log10(juce::jmax(otherPower, 1.0e-30) / juce::jmax(harmonicPower, 1.0e-30));
+
+            // Throughput on noise.
+            auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate) / blockSize);
+            double elapsed = 0.0;
+
+            for (int b = 0; b < numBlocks; ++b) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    for (int i = 0; i < blockSize; ++i)
+                        buffer.setSample(ch, i, random.nextFloat() - 0.5f);
+
+                auto start = juce::Time::getHighResolutionTicks();
+                overdrive.process(juce::dsp::ProcessContextReplacing<float>(block));
+                elapsed += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            }
+
+            auto nsPerSample = elapsed * 1.0e9 / (static_cast<double>(numBlocks) * blockSize);
+            auto factor = 1 << order;
+
+            std::cout << juce::String(kernelName).paddedRight(' ', 10)
+                      << juce::String(factor).paddedLeft(' ', 2) << "x  "
+                      << juce::String(nsPerSample, 2).paddedLeft(' ', 8) << " ns/sample  "
+                      << "latency " << juce::String(overdrive.getLatencyInSamples()).paddedLeft(' ', 3) << "  "
+                      << "aliasing " << juce::String(aliasingDb, 1) << " dB"
+                      << std::endl;
+
+            juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+            obj->setProperty("kernel", juce::String(kernelName));
+            obj->setProperty("oversampling", factor);
+            obj->setProperty("nsPerSample", nsPerSample);
+            obj->setProperty("latencySamples", overdrive.getLatencyInSamples());
+            obj->setProperty("aliasingDb", aliasingDb);
+            results.add(juce::var(obj.get()));
+        }
+    }
+
+    if (args.containsOption("--output")) {
+        juce::NamedValueSet metadata;
+        metadata.set("drive", drive);
+        metadata.set("toneHz", toneHz);
+        writeResults(args, "overdrive", results, metadata);
+    }
+}
+
+//==============================================================================
+void runProfile(const juce::ArgumentList& args) {
+    using Stage = ChainProfiler::Stage;
+
+    if constexpr (! ChainProfiler::isEnabled)
+        juce::ConsoleApplication::fail("Built without JUCETUTORIALS_PROFILING, so there is nothing to profile: use the Profile configuration");
+
+    auto sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    auto blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 256;
+    auto numBusChannels = args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2;
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 10.0;
+    auto presetName = args.containsOption("--preset") ? args.getValueForOption("--preset") : juce::String("Heavy");
+    auto dispatches = getDispatches(args.containsOption("--dispatch") ? args.getValueForOption("--dispatch") : juce::String("specialized"));
+
+    if (sampleRate <= 0.0 || blockSize <= 0 || seconds <= 0.0)
+        juce::ConsoleApplication::fail("--sample-rate, --block-size and --seconds must be positive");
+
+    if (! juce::isPositiveAndNotGreaterThan(numBusChannels, JucetutorialsAudioProcessor::maxNumChannels))
+        juce::ConsoleApplication::fail("Invalid channel count: " + juce::String(numBusChannels));
+
+    if (dispatches.size() != 1)
+        juce::ConsoleApplication::fail("--dispatch must be specialized or pointers");
+
+    auto presets = getBenchmarkPresets();
+    auto preset = std::find_if(presets.begin(), presets.end(), [&](const auto& p) { return p.name == presetName; });
+
+    if (preset == presets.end())
+        juce::ConsoleApplication::fail("Unknown --preset: " + presetName);
+
+    JucetutorialsAudioProcessor processor;
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+
+    if (! processor.setBusesLayout(layout))
+        juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numBusChannels));
+
+    processor.setChainDispatch(dispatches.front());
+    applyPreset(processor, *preset);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto source = args.containsOption("--input") ? loadInput(args.getExistingFileForOption("--input"), numBusChannels)
+                                                 : makeTestSignal(numBusChannels, sampleRate);
+
+    juce::AudioBuffer<float> buffer(numBusChannels, blockSize);
+    juce::MidiBuffer midi;
+    int readPosition = 0;
+
+    auto processNextBlock = [&] {
+        for (int done = 0; done < blockSize;) {
+            auto num = juce::jmin(blockSize - done, source.getNumSamples() - readPosition);
+
+            for (int ch = 0; ch < numBusChannels; ++ch)
+                buffer.copyFrom(ch, done, source, ch % source.getNumChannels(), readPosition, num);
+
+            done += num;
+            readPosition = (readPosition + num) % source.getNumSamples();
+        }
+
+        processor.processBlock(buffer, midi);
+    };
+
+    // Warm up, then start the histograms and the trace from a clean slate.
+    for (int i = 0; i < 16; ++i)
+        processNextBlock();
+
+    auto& profiler = processor.getProfiler();
+    auto trace = args.containsOption("--trace");
+    std::vector<ChainProfiler::Event> events;
+
+    profiler.reset();
+    profiler.setTracing(trace);
+
+    auto numBlocks = juce::jmax(1, static_cast<int>(seconds * sampleRate) / blockSize);
+
+    for (int i = 0; i < numBlocks; ++i) {
+        processNextBlock();
+        profiler.readEvents([&](const ChainProfiler::Event& e) { events.push_back(e); });
+    }
+
+    profiler.setTracing(false);
+    processor.releaseResources();
+
+    // Slot stages are labelled with the module they ran.
+    auto graph = processor.getGraph();
+
+    std::cout << numBlocks << " blocks of " << blockSize << " at " << juce::String(sampleRate, 0) << " Hz, "
+              << numBusChannels << " ch, preset " << preset->name << ", "
+              << getDispatchName(dispatches.front()) << " dispatch" << std::endl;
+
+    for (size_t i = 0; i < ChainProfiler::numStages; ++i) {
+        auto stage = static_cast<Stage>(i);
+        auto summary = profiler.getSummary(stage);
+
+        if (summary.count == 0)
+            continue;
+
+        auto name = ChainProfiler::getStageName(stage);
+
+        if (i >= static_cast<size_t>(Stage::Slot0)) {
+            auto slot = i - static_cast<size_t>(Stage::Slot0);
+
+            if (slot < graph.size())
+                name << " " << getOptionName(graph[slot].option) << (graph[slot].instance > 0 ? " " + juce::String(graph[slot].instance + 1) : juce::String());
+        }
+
+        auto meanCycles = static_cast<double>(summary.totalCycles) / static_cast<double>(summary.count);
+
+        std::cout << name.paddedRight(' ', 24)
+                  << juce::String(static_cast<juce::int64>(summary.count)).paddedLeft(' ', 8) << " calls  "
+                  << "mean " << juce::String(ChainProfiler::cyclesToMicros(meanCycles), 2).paddedLeft(' ', 8) << " us  "
+                  << "p50 " << juce::String(ChainProfiler::cyclesToMicros(summary.p50Cycles), 2).paddedLeft(' ', 8) << " us  "
+                  << "p99 " << juce::String(ChainProfiler::cyclesToMicros(summary.p99Cycles), 2).paddedLeft(' ', 8) << " us  "
+                  << "max " << juce::String(ChainProfiler::cyclesToMicros(static_cast<double>(summary.maxCycles)), 2).paddedLeft(' ', 8) << " us"
+                  << std::endl;
+    }
+
+    if (! trace)
+        return;
+
+    // Chrome trace format: complete ("X") events in microseconds, all on one
+    // thread so the slots nest under their block.
+    auto origin = events.empty() ? std::uint64_t {} : events.front().startCycles;
+
+    for (const auto& e : events)
+        origin = juce::jmin(origin, e.startCycles);
+
+    juce::Array<juce::var> traceEvents;
+
+    for (const auto& e : events) {
+        juce::DynamicObject::Ptr obj = new juce::DynamicObject();
+        auto name = ChainProfiler::getStageName(e.stage);
+
+        if (e.module >= 0)
+            name << " " << getOptionName(static_cast<DSP_Option>(e.module));
+
+        obj->setProperty("name", name);
+        obj->setProperty("cat", e.module >= 0 ? "slot" : "stage");
+        obj->setProperty("ph", "X");
+        obj->setProperty("ts", ChainProfiler::cyclesToMicros(static_cast<double>(e.startCycles - origin)));
+        obj->setProperty("dur", ChainProfiler::cyclesToMicros(static_cast<double>(e.endCycles - e.startCycles)));
+        obj->setProperty("pid", 1);
+        obj->setProperty("tid", 1);
+        traceEvents.add(juce::var(obj.get()));
+    }
+
+    juce::DynamicObject::Ptr root = new juce::DynamicObject();
+    root->setProperty("traceEvents", traceEvents);
+    root->setProperty("displayTimeUnit", "ns");
+
+    auto traceFile = args.getFileForOption("--trace");
+
+    if (! traceFile.replaceWithText(juce::JSON::toString(juce::var(root.get()), true)))
+        juce::ConsoleApplication::fail("Could not write " + traceFile.getFullPathName());
+
+    std::cout << "Wrote " << events.size() << " events to " << traceFile.getFullPathName();
+
+    if (auto dropped = profiler.getNumDroppedEvents(); dropped > 0)
+        std::cout << " (" << dropped << " dropped)";
+
+    std::cout << std::endl;
+}
+
+//==============================================================================
+void runMemoryReport(const juce::ArgumentList& args) {
+    auto sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    auto blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 512;
+    auto numBusChannels = args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2;
+    auto numInstances = args.containsOption("--instances") ? args.getValueForOption("--instances").getIntValue() : 100;
+    auto presetName = args.containsOption("--preset") ? args.getValueForOption("--preset") : juce::String("Default");
+    auto bypassNames = getListOption(args, "--bypass", "");
+
+    if (sampleRate <= 0.0 || blockSize <= 0 || numInstances <= 0)
+        juce::ConsoleApplication::fail("--sample-rate, --block-size and --instances must be positive");
+
+    if (! juce::isPositiveAndNotGreaterThan(numBusChannels, JucetutorialsAudioProcessor::maxNumChannels))
+        juce::ConsoleApplication::fail("Invalid channel count: " + juce::String(numBusChannels));
+
+    auto presets = getBenchmarkPresets();
+    auto preset = std::find_if(presets.begin(), presets.end(), [&](const auto& p) { return p.name == presetName; });
+
+    if (preset == presets.end())
+        juce::ConsoleApplication::fail("Unknown --preset: " + presetName);
+
+    auto options = getOrders(false).front();
+    std::vector<DSP_Option> bypassed;
+
+    for (const auto& name : bypassNames) {
+        auto option = std::find_if(options.begin(), options.end(), [&](auto o) { return getOptionName(o) == name.trim(); });
+
+        if (option == options.end())
+            juce::ConsoleApplication::fail("Unknown module in --bypass: " + name + " (one of " + getOrderName(options).replace(">", ", ") + ")");
+
+        bypassed.push_back(*option);
+    }
+
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numBusChannels));
+
+    auto residentBefore = getResidentBytes();
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    std::vector<std::unique_ptr<JucetutorialsAudioProcessor>> processors;
+
+    for (int i = 0; i < numInstances; ++i) {
+        auto processor = std::make_unique<JucetutorialsAudioProcessor>();
+
+        if (! processor->setBusesLayout(layout))
+            juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numBusChannels));
+
+        applyPreset(*processor, *preset);
+
+        for (auto option : bypassed)
+            processor->getBypassParameter(option)->setValueNotifyingHost(1.f);
+
+        processors.push_back(std::move(processor));
+    }
+
+    auto constructedTicks = juce::Time::getHighResolutionTicks();
+
+    for (auto& processor : processors) {
+        processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+    }
+
+    auto preparedTicks = juce::Time::getHighResolutionTicks();
+    auto residentAfter = getResidentBytes();
+
+    auto printFootprint = [](const JucetutorialsAudioProcessor::MemoryFootprint& footprint) {
+        for (size_t i = 0; i < footprint.moduleBytes.size(); ++i)
+            std::cout << "  " << getOptionName(static_cast<DSP_Option>(i)).paddedRight(' ', 16)
+                      << (juce::String(footprint.numPrepared[i]) + "/" + juce::String(JucetutorialsAudioProcessor::instancesPerModule) + " prepared").paddedRight(' ', 14)
+                      << formatBytes(static_cast<juce::int64>(footprint.moduleBytes[i])).paddedLeft(' ', 12) << std::endl;
+
+        std::cout << "  " << juce::String("Chain").paddedRight(' ', 26) << formatBytes(static_cast<juce::int64>(footprint.chainBytes)).paddedLeft(' ', 12) << std::endl
+                  << "  " << juce::String("Analyser").paddedRight(' ', 26) << formatBytes(static_cast<juce::int64>(footprint.analyserBytes)).paddedLeft(' ', 12) << std::endl
+                  << "  " << juce::String("Programs").paddedRight(' ', 26) << formatBytes(static_cast<juce::int64>(footprint.programBytes)).paddedLeft(' ', 12) << std::endl
+                  << "  " << juce::String("Total").paddedRight(' ', 26) << formatBytes(static_cast<juce::int64>(footprint.getTotalBytes())).paddedLeft(' ', 12) << std::endl;
+    };
+
+    std::cout << numInstances << " instances at " << juce::String(sampleRate, 0) << " Hz, block " << blockSize << ", "
+              << numBusChannels << " ch, preset " << preset->name;
+
+    if (! bypassed.empty())
+        std::cout << ", bypassing " << bypassNames.joinIntoString(",");
+
+    std::cout << std::endl
+              << "Constructed in " << juce::String(juce::Time::highResolutionTicksToSeconds(constructedTicks - startTicks) * 1000.0, 1) << " ms, "
+              << "prepared in " << juce::String(juce::Time::highResolutionTicksToSeconds(preparedTicks - constructedTicks) * 1000.0, 1) << " ms" << std::endl;
+
+    if (residentBefore > 0 && residentAfter > 0)
+        std::cout << "Resident memory grew by " << formatBytes(residentAfter - residentBefore)
+                  << ", " << formatBytes((residentAfter - residentBefore) / numInstances) << " per instance" << std::endl;
+
+    std::cout << "Prepared instance:" << std::endl;
+    printFootprint(processors.front()->getMemoryFootprint());
+
+    for (auto& processor : processors)
+        processor->releaseResources();
+
+    std::cout << "After releaseResources:" << std::endl;
+    printFootprint(processors.front()->getMemoryFootprint());
+}
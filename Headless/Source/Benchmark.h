@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    Offline render benchmark for JucetutorialsAudioProcessor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Renders generated or WAV input through the processor for every requested
+    sample rate, block size, DSP_Order and preset, printing a summary and
+    optionally writing the results as JSON.
+*/
+void runBenchmark (const juce::ArgumentList& args);
+
+/** Checks MultiChannelBiquad against one scalar juce::dsp::IIR::Filter per
+    channel, then compares their throughput for several channel counts.
+    Fails if the outputs differ by more than a small tolerance.
+*/
+void runBiquadBenchmark (const juce::ArgumentList& args);
+
+/** Checks CrossoverSplitter against a tree of juce::dsp::LinkwitzRileyFilter,
+    as SimpleMultiBandComp builds it, for 2 to 4 bands, then compares their
+    throughput. Fails if any band differs by more than a small tolerance.
+*/
+void runCrossoverBenchmark (const juce::ArgumentList& args);
+
+/** Times every Overdrive kernel at every oversampling factor and estimates
+    how much aliasing each combination leaves in a driven high sine.
+*/
+void runOverdriveBenchmark (const juce::ArgumentList& args);
+
+/** Renders through one processor with the stage and slot timers running,
+    then prints each stage's histogram summary and optionally writes every
+    timing as a Chrome trace. Needs the Profile configuration, the only one
+    built with JUCETUTORIALS_PROFILING.
+*/
+void runProfile (const juce::ArgumentList& args);
+
+/** Creates and prepares many processors with one preset, like a session
+    full of instances, then prints one instance's memory footprint by module,
+    before and after releaseResources, with the time taken and the growth in
+    resident memory where the OS reports it.
+*/
+void runMemoryReport (const juce::ArgumentList& args);
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    Headless entry point: runs the plugin's processor without a host or GUI.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+#include "BatchRender.h"
+#include "RealtimeCheck.h"
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // The APVTS and its timers need a message manager, even without a display.
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ConsoleApplication app;
+    app.addHelpCommand ("--help|-h", "Usage: juce-tutorials-headless <command> [options]", true);
+
+    app.addCommand ({ "benchmark",
+                      "benchmark [--sample-rates=44100,48000,96000] [--block-sizes=64,256,1024] [--seconds=2]"
+                      " [--channels=2] [--input=file.wav] [--orders=default|all] [--dispatch=both|specialized|pointers]"
+                      " [--min-sub-block=64] [--automate] [--output=results.json]",
+                      "Renders audio through the effect chain and reports its cost.",
+                      "Measures ns/sample, realtime factor and per-block latency percentiles for every\n"
+                      "sample rate, block size and benchmark preset, in the default DSP_Order; --orders=all\n"
+                      "runs all 720 permutations instead.\n"
+                      "--dispatch compares the specialised chain against the pointer-array path.\n"
+                      "--channels takes bus widths up to 16, e.g. 1,2,6,8,12,16, and also reports the\n"
+                      "cost per channel-sample, which falls as SIMD groups fill up.\n"
+                      "--automate sweeps a filter parameter every block; blocks with a parameter change\n"
+                      "are split into sub-blocks of at least --min-sub-block samples.\n"
+                      "Without --input, a generated stereo test signal is used.",
+                      [] (const juce::ArgumentList& args) { runBenchmark (args); } });
+
+    app.addCommand ({ "biquad",
+                      "biquad [--channels=1,2,4,6,8,16] [--seconds=2] [--output=results.json]",
+                      "Checks and times the SIMD biquad against juce::dsp::IIR::Filter.",
+                      "Fails if MultiChannelBiquad and one scalar IIR::Filter per channel disagree,\n"
+                      "then reports ns per channel-sample for both.",
+                      [] (const juce::ArgumentList& args) { runBiquadBenchmark (args); } });
+
+    app.addCommand ({ "crossover",
+                      "crossover [--channels=1,2,8] [--seconds=2] [--output=results.json]",
+                      "Checks and times the SIMD band splitter against juce::dsp::LinkwitzRileyFilter.",
+                      "Fails if CrossoverSplitter and a tree of scalar Linkwitz-Riley filters disagree\n"
+                      "for 2, 3 or 4 bands, then reports ns per channel-sample for both.",
+                      [] (const juce::ArgumentList& args) { runCrossoverBenchmark (args); } });
+
+    app.addCommand ({ "overdrive",
+                      "overdrive [--drive=8] [--seconds=2] [--output=results.json]",
+                      "Times each overdrive kernel at 1x, 2x, 4x and 8x oversampling.",
+                      "Reports ns/sample, added latency and the level of aliasing relative to the\n"
+                      "harmonics of a driven 5 kHz tone, for every kernel and oversampling factor.",
+                      [] (const juce::ArgumentList& args) { runOverdriveBenchmark (args); } });
+
+    app.addCommand ({ "profile",
+                      "profile [--sample-rate=48000] [--block-size=256] [--channels=2] [--seconds=10]"
+                      " [--preset=Heavy] [--dispatch=specialized|pointers] [--input=file.wav] [--trace=trace.json]",
+                      "Times each stage of processBlock and each slot of the chain.",
+                      "Prints call counts and mean, p50, p99 and max microseconds for the order handoff,\n"
+                      "the parameter update, every slot and the whole block, from cycle-counter histograms.\n"
+                      "--trace writes every timing as Chrome trace JSON, for chrome://tracing or Perfetto.\n"
+                      "Presets are the benchmark's Default, Subtle and Heavy. Only the Profile build\n"
+                      "has the timers; the others leave them out of processBlock.",
+                      [] (const juce::ArgumentList& args) { runProfile (args); } });
+
+    app.addCommand ({ "memory",
+                      "memory [--instances=100] [--sample-rate=48000] [--block-size=512] [--channels=2]"
+                      " [--preset=Default] [--bypass=Phase,Chorus,...]",
+                      "Reports the memory and startup time of many prepared instances.",
+                      "Constructs and prepares --instances processors, then prints the time each step took,\n"
+                      "the growth in resident memory, and one instance's heap footprint by module, before and\n"
+                      "after releaseResources. Modules named in --bypass are bypassed before preparing, so\n"
+                      "they are never allocated. Presets are the benchmark's Default, Subtle and Heavy.",
+                      [] (const juce::ArgumentList& args) { runMemoryReport (args); } });
+
+    app.addCommand ({ "render",
+                      "render --output-dir=dir [--preset=name|--state=file] [--order=Phase,Chorus,...]"
+                      " [--threads=N] [--block-size=512] [--tail] [--list=files.txt] [files...]",
+                      "Renders audio files through the effect chain on every core.",
+                      "Each worker thread owns one processor and takes the next file whenever it is idle.\n"
+                      "Files stream through in fixed-size chunks, so memory use doesn't depend on their length.\n"
+                      "--preset picks a factory program by name, --state loads a saved plugin state.\n"
+                      "Outputs are WAV files named after their inputs, compensated for the chain's latency;\n"
+                      "--tail extends them by the chain's tail. Reports realtime seconds per wall second.",
+                      [] (const juce::ArgumentList& args) { runBatchRender (args); } });
+
+    app.addCommand ({ "rtcheck",
+                      "rtcheck [--sample-rate=48000] [--block-size=256] [--channels=1,2,6] [--steps=8]",
+                      "Fails if processBlock allocates, locks or blocks.",
+                      "Runs every factory program, --steps values of every parameter, every DSP_Order with\n"
+                      "both dispatches, a state reload, identical channels and silence, with allocation,\n"
+                      "lock and blocking calls intercepted on the audio thread. Prints the stack of the first\n"
+                      "violations. Only available in the Debug configuration, built with JUCETUTORIALS_RTCHECK.",
+                      [] (const juce::ArgumentList& args) { runRealtimeCheck (args); } });
+
+    return app.findAndRunCommand (argc, argv);
+}
@@ -0,0 +1,316 @@
+/*
+  ==============================================================================
+
+    Real-time safety check of JucetutorialsAudioProcessor::processBlock.
+
+  ==============================================================================
+*/
+
+#include "RealtimeCheck.h"
+#include "RealtimeHooks.h"
+#include "../../Source/PluginProcessor.h"
+
+#if JUCETUTORIALS_RTCHECK
+
+namespace
+{
+    using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+    using DSP_Order = JucetutorialsAudioProcessor::DSP_Order;
+    using DSP_Graph = JucetutorialsAudioProcessor::DSP_Graph;
+    using ChainDispatch = JucetutorialsAudioProcessor::ChainDispatch;
+
+    constexpr int maxReportedViolations = 5;
+
+    std::atomic<int> numViolations { 0 };
+    std::atomic<const char*> currentStep { "" };
+
+    void reportViolation(const char* function) {
+        if (numViolations.fetch_add(1) >= maxReportedViolations)
+            return;
+
+        std::cerr << "Real-time violation: " << function << " in processBlock during " << currentStep.load() << "\n"
+                  << juce::SystemStats::getStackBacktrace() << std::endl;
+    }
+
+    /** Stands in for a plugin wrapper, which hears of latency and display
+        changes under a lock and passes them on to the host through a message
+        posted to the message thread, as JUCE's do.
+    */
+    class HostNotifications : public juce::AudioProcessorListener,
+                              private juce::AsyncUpdater
+    {
+    public:
+        void audioProcessorParameterChanged(juce::AudioProcessor*, int, float) override {}
+
+        void audioProcessorChanged(juce::AudioProcessor*, const ChangeDetails&) override {
+            const juce::ScopedLock lock(changesLock);
+            triggerAsyncUpdate();
+        }
+
+    private:
+        void handleAsyncUpdate() override {}
+
+        juce::CriticalSection changesLock;
+    };
+
+    class CheckedHost
+    {
+    public:
+        CheckedHost(double sampleRate, int blockSize, int numChannels)
+            : sampleRate(sampleRate), blockSize(blockSize), buffer(numChannels, blockSize) {
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+            layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+            if (! processor.setBusesLayout(layout))
+                juce::ConsoleApplication::fail("Unsupported channel count: " + juce::String(numChannels));
+
+            processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+
+            // Without a listener, updateHostDisplay and setLatencySamples reach nothing.
+            processor.addListener(&notifications);
+        }
+
+        ~CheckedHost() {
+            processor.removeListener(&notifications);
+            processor.releaseResources();
+        }
+
+        enum class Input
+        {
+            Distinct,   // a different tone in every channel
+            Identical,  // the same tone in every channel, so the chain can collapse to mono
+            Silent
+        };
+
+        /** The input is generated outside the check; only processBlock runs inside it. */
+        void process(int numBlocks, Input input = Input::Distinct) {
+            for (int i = 0; i < numBlocks; ++i) {
+                fill(input);
+
+                RealtimeHooks::setActive(true);
+                processor.processBlock(buffer, midi);
+                RealtimeHooks::setActive(false);
+            }
+        }
+
+        JucetutorialsAudioProcessor processor;
+        const double sampleRate;
+        const int blockSize;
+
+    private:
+        void fill(Input input) {
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+                auto* data = buffer.getWritePointer(ch);
+                auto frequency = 110.0 + (input == Input::Identical ? 0.0 : 37.0 * ch);
+
+                for (int i = 0; i < blockSize; ++i) {
+                    auto phase = juce::MathConstants<double>::twoPi * frequency * static_cast<double>(position + i) / sampleRate;
+                    data[i] = input == Input::Silent ? 0.f : static_cast<float>(0.3 * std::sin(phase));
+                }
+            }
+
+            position += blockSize;
+        }
+
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+        HostNotifications notifications;
+    };
+
+    std::vector<DSP_Order> getAllOrders() {
+        DSP_Order order;
+
+        for (size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<DSP_Option>(i);
+
+        std::vector<DSP_Order> orders;
+
+        do {
+            orders.push_back(order);
+        } while (std::next_permutation(order.begin(), order.end()));
+
+        return orders;
+    }
+
+    void checkPrograms(CheckedHost& host) {
+        currentStep = "program changes";
+
+        for (int i = 0; i < host.processor.getNumPrograms(); ++i) {
+            host.processor.setCurrentProgram(i);
+            host.process(16);
+        }
+    }
+
+    void checkParameterSweeps(CheckedHost& host, int numSteps) {
+        currentStep = "parameter sweeps";
+
+        for (auto* parameter : host.processor.getParameters()) {
+            auto defaultValue = parameter->getDefaultValue();
+
+            for (int step = 0; step <= numSteps; ++step) {
+                parameter->setValueNotifyingHost(static_cast<float>(step) / static_cast<float>(numSteps));
+                host.process(2);
+            }
+
+            parameter->setValueNotifyingHost(defaultValue);
+            host.process(2);
+        }
+    }
+
+    void checkOrders(CheckedHost& host) {
+        // Enough blocks for the fade out, the swap and the fade back in.
+        auto blocksPerOrder = juce::jmax(4, static_cast<int>(0.1 * host.sampleRate) / host.blockSize);
+
+        for (auto dispatch : { ChainDispatch::Specialized, ChainDispatch::PointerArray }) {
+            currentStep = dispatch == ChainDispatch::Specialized ? "order changes, specialized" : "order changes, pointers";
+            host.processor.setChainDispatch(dispatch);
+
+            for (const auto& order : getAllOrders()) {
+                host.processor.setDSPOrder(order);
+                host.process(blocksPerOrder);
+            }
+        }
+
+        host.processor.setChainDispatch(ChainDispatch::Specialized);
+    }
+
+    void checkGraphEdits(CheckedHost& host) {
+        currentStep = "graph edits";
+
+        // Long enough for the worker to prepare a newly added instance too.
+        auto blocksPerEdit = juce::jmax(8, static_cast<int>(0.25 * host.sampleRate) / host.blockSize);
+        auto original = host.processor.getGraph();
+        auto graph = original;
+
+        // Fill the graph with second instances, then take it down to nothing.
+        for (size_t i = 0; i < static_cast<size_t>(DSP_Option::END_OF_LIST) && ! graph.isFull(); ++i) {
+            auto option = static_cast<DSP_Option>(i);
+
+            if (auto instance = graph.getFreeInstance(option); instance.has_value() && graph.insert(i * 2 + 1, { option, *instance })) {
+                host.processor.setGraph(graph);
+                host.process(blocksPerEdit);
+            }
+        }
+
+        while (graph.remove(0)) {
+            host.processor.setGraph(graph);
+            host.process(blocksPerEdit);
+        }
+
+        host.processor.setGraph(original);
+        host.process(blocksPerEdit);
+    }
+
+    void checkBands(CheckedHost& host) {
+        currentStep = "band splits";
+
+        // The modules are re-prepared for every band count while the chain is dry.
+        auto blocksPerEdit = juce::jmax(8, static_cast<int>(0.25 * host.sampleRate) / host.blockSize);
+        auto* bands = host.processor.numBandsParameter;
+        auto shared = host.processor.getGraph();
+
+        // Band 1 without the first slot, which runs the shared instances over
+        // a subset of the bands, then with second instances of its own in the
+        // opposite order, which also puts the bands' latencies apart.
+        auto withoutFirst = shared;
+        withoutFirst.remove(0);
+
+        DSP_Graph ownInstances;
+        ownInstances.insert(0, { shared[shared.size() - 1].option, 1 });
+        ownInstances.insert(1, { DSP_Option::Overdrive, 1 });
+        ownInstances.insert(2, { shared[0].option, 1 });
+
+        for (int index = 1; index < bands->choices.size(); ++index) {
+            bands->setValueNotifyingHost(bands->convertTo0to1(static_cast<float>(index)));
+            host.process(blocksPerEdit);
+
+            for (const auto& graph : { withoutFirst, ownInstances }) {
+                host.processor.setGraph(graph, 1);
+                host.process(blocksPerEdit);
+            }
+
+            host.processor.setBandFollowsFirst(1);
+            host.process(blocksPerEdit);
+        }
+
+        bands->setValueNotifyingHost(bands->getDefaultValue());
+        host.process(blocksPerEdit);
+    }
+
+    void checkStateReload(CheckedHost& host) {
+        currentStep = "state reload";
+
+        juce::MemoryBlock state;
+        host.processor.getStateInformation(state);
+        host.processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+        host.process(16);
+    }
+
+    void checkMonoCollapse(CheckedHost& host) {
+        currentStep = "mono collapse";
+
+        auto blocksPastTail = static_cast<int>((host.processor.getTailLengthSeconds() + 0.5) * host.sampleRate) / host.blockSize;
+        host.process(blocksPastTail, CheckedHost::Input::Identical);
+        host.process(16, CheckedHost::Input::Distinct);
+    }
+
+    void checkSleep(CheckedHost& host) {
+        currentStep = "silence and wake up";
+
+        auto blocksPastTail = static_cast<int>((host.processor.getTailLengthSeconds() + 0.5) * host.sampleRate) / host.blockSize;
+        host.process(blocksPastTail, CheckedHost::Input::Silent);
+        host.process(16, CheckedHost::Input::Distinct);
+    }
+}
+#endif
+
+//==============================================================================
+void runRealtimeCheck(const juce::ArgumentList& args) {
+   #if ! JUCETUTORIALS_RTCHECK
+    juce::ignoreUnused(args);
+    juce::ConsoleApplication::fail("Built without JUCETUTORIALS_RTCHECK: use the Debug configuration of the headless project");
+   #else
+    auto sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    auto blockSize = args.containsOption("--block-size") ? args.getValueForOption("--block-size").getIntValue() : 256;
+    auto numSteps = args.containsOption("--steps") ? args.getValueForOption("--steps").getIntValue() : 8;
+    auto channelText = args.containsOption("--channels") ? args.getValueForOption("--channels") : juce::String("1,2,6");
+
+    if (sampleRate <= 0.0 || blockSize <= 0 || numSteps <= 0)
+        juce::ConsoleApplication::fail("--sample-rate, --block-size and --steps must be positive");
+
+    RealtimeHooks::setViolationHandler(reportViolation);
+
+    for (const auto& text : juce::StringArray::fromTokens(channelText, ",", "")) {
+        auto numChannels = text.getIntValue();
+
+        if (! juce::isPositiveAndNotGreaterThan(numChannels, JucetutorialsAudioProcessor::maxNumChannels))
+            juce::ConsoleApplication::fail("Invalid channel count: " + text);
+
+        auto violationsBefore = numViolations.load();
+
+        // Constructed and prepared unchecked: only processBlock has to be real-time safe.
+        CheckedHost host(sampleRate, blockSize, numChannels);
+
+        checkPrograms(host);
+        checkParameterSweeps(host, numSteps);
+        checkOrders(host);
+        checkGraphEdits(host);
+        checkBands(host);
+        checkStateReload(host);
+        checkMonoCollapse(host);
+        checkSleep(host);
+
+        std::cout << numChannels << " ch: " << (numViolations.load() - violationsBefore) << " violations" << std::endl;
+    }
+
+    RealtimeHooks::setViolationHandler(nullptr);
+
+    if (auto total = numViolations.load(); total > 0)
+        juce::ConsoleApplication::fail(juce::String(total) + " real-time violations in processBlock");
+
+    std::cout << "processBlock is real-time safe" << std::endl;
+   #endif
+}
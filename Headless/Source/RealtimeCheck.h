@@ -0,0 +1,23 @@
+/*
+  ==============================================================================
+
+    Real-time safety check of JucetutorialsAudioProcessor::processBlock.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Drives the processor through every factory program, a sweep of every
+    parameter, every DSP_Order permutation with both dispatches, slots added
+    to and removed from the graph, every band count with a band on its own graph, a
+    state reload, mono-collapsed input and sleeping on silence, while
+    processBlock is watched for allocations, locks and blocking calls.
+
+    Prints the stack of the first violations and fails if there were any.
+    Needs a JUCETUTORIALS_RTCHECK build, which is the Debug configuration of
+    the headless project.
+*/
+void runRealtimeCheck (const juce::ArgumentList& args);
@@ -0,0 +1,229 @@
+/*
+  ==============================================================================
+
+    Allocation, lock and blocking-call interposers for real-time checks.
+
+  ==============================================================================
+*/
+
+#include "RealtimeHooks.h"
+
+#if JUCETUTORIALS_RTCHECK
+
+// Deliberately not including the C headers that declare the functions
+// replaced below: their declarations differ in exception specifications
+// between glibc versions, and only the symbol names matter for linking.
+#include <cstddef>
+#include <new>
+#include <dlfcn.h>
+
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+    void __libc_free(void*);
+}
+
+namespace
+{
+    thread_local bool isActive = false;
+    RealtimeHooks::ViolationHandler violationHandler = nullptr;
+
+    void violation(const char* function) noexcept {
+        if (! isActive)
+            return;
+
+        isActive = false;
+
+        if (auto handler = __atomic_load_n(&violationHandler, __ATOMIC_ACQUIRE))
+            handler(function);
+
+        isActive = true;
+    }
+
+    // Looked up on first use. Caching in a plain static avoids the guard of
+    // a function-local initialiser, which could lock and land back here.
+    template<typename Function>
+    Function getNext(Function& cache, const char* name) noexcept {
+        auto function = __atomic_load_n(&cache, __ATOMIC_RELAXED);
+
+        if (function == nullptr) {
+            function = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+            __atomic_store_n(&cache, function, __ATOMIC_RELAXED);
+        }
+
+        return function;
+    }
+}
+
+void RealtimeHooks::setViolationHandler(ViolationHandler handler) noexcept {
+    __atomic_store_n(&violationHandler, handler, __ATOMIC_RELEASE);
+}
+
+bool RealtimeHooks::setActive(bool shouldBeActive) noexcept {
+    auto wasActive = isActive;
+    isActive = shouldBeActive;
+    return wasActive;
+}
+
+//==============================================================================
+// Allocation: forwarded straight to glibc's allocator, so no lookup is needed.
+extern "C"
+{
+    void* malloc(std::size_t size) {
+        violation("malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(std::size_t count, std::size_t size) {
+        violation("calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* ptr, std::size_t size) {
+        violation("realloc");
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(std::size_t alignment, std::size_t size) {
+        violation("memalign");
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(std::size_t alignment, std::size_t size) {
+        violation("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** result, std::size_t alignment, std::size_t size) {
+        violation("posix_memalign");
+
+        if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+            return 22;  // EINVAL
+
+        auto* ptr = __libc_memalign(alignment, size);
+
+        if (ptr == nullptr)
+            return 12;  // ENOMEM
+
+        *result = ptr;
+        return 0;
+    }
+
+    void free(void* ptr) {
+        if (ptr != nullptr)
+            violation("free");
+
+        __libc_free(ptr);
+    }
+}
+
+void* operator new(std::size_t size) {
+    violation("operator new");
+
+    if (auto* ptr = __libc_malloc(size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    violation("operator new[]");
+
+    if (auto* ptr = __libc_malloc(size != 0 ? size : 1))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    if (ptr != nullptr)
+        violation("operator delete");
+
+    __libc_free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    if (ptr != nullptr)
+        violation("operator delete[]");
+
+    __libc_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { operator delete[](ptr); }
+
+//==============================================================================
+// Locks, waits and blocking system calls: reported, then passed on to libc.
+extern "C"
+{
+    int pthread_mutex_lock(void* mutex) {
+        violation("pthread_mutex_lock");
+        static int (*next)(void*) = nullptr;
+        return getNext(next, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(void* lock) {
+        violation("pthread_rwlock_rdlock");
+        static int (*next)(void*) = nullptr;
+        return getNext(next, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(void* lock) {
+        violation("pthread_rwlock_wrlock");
+        static int (*next)(void*) = nullptr;
+        return getNext(next, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(void* condition, void* mutex) {
+        violation("pthread_cond_wait");
+        static int (*next)(void*, void*) = nullptr;
+        return getNext(next, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(void* condition, void* mutex, const void* time) {
+        violation("pthread_cond_timedwait");
+        static int (*next)(void*, void*, const void*) = nullptr;
+        return getNext(next, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int sem_wait(void* semaphore) {
+        violation("sem_wait");
+        static int (*next)(void*) = nullptr;
+        return getNext(next, "sem_wait")(semaphore);
+    }
+
+    int nanosleep(const void* duration, void* remaining) {
+        violation("nanosleep");
+        static int (*next)(const void*, void*) = nullptr;
+        return getNext(next, "nanosleep")(duration, remaining);
+    }
+
+    int usleep(unsigned int micros) {
+        violation("usleep");
+        static int (*next)(unsigned int) = nullptr;
+        return getNext(next, "usleep")(micros);
+    }
+
+    int sched_yield() {
+        violation("sched_yield");
+        static int (*next)() = nullptr;
+        return getNext(next, "sched_yield")();
+    }
+
+    long read(int fd, void* buffer, std::size_t size) {
+        violation("read");
+        static long (*next)(int, void*, std::size_t) = nullptr;
+        return getNext(next, "read")(fd, buffer, size);
+    }
+
+    long write(int fd, const void* buffer, std::size_t size) {
+        violation("write");
+        static long (*next)(int, const void*, std::size_t) = nullptr;
+        return getNext(next, "write")(fd, buffer, size);
+    }
+}
+
+#endif
@@ -0,0 +1,31 @@
+/*
+  ==============================================================================
+
+    Allocation, lock and blocking-call interposers for real-time checks.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#ifndef JUCETUTORIALS_RTCHECK
+ #define JUCETUTORIALS_RTCHECK 0
+#endif
+
+/** Only JUCETUTORIALS_RTCHECK builds define these, in RealtimeHooks.cpp.
+
+    Those builds replace malloc and friends, operator new and delete, the
+    pthread lock and wait functions, and sleeping, reading and writing. Each
+    replacement calls the handler while the calling thread is marked active,
+    then carries on as usual. The thread is unmarked while the handler runs,
+    so the handler itself may allocate.
+*/
+namespace RealtimeHooks
+{
+    using ViolationHandler = void (*)(const char* function);
+
+    void setViolationHandler(ViolationHandler handler) noexcept;
+
+    /** Marks or unmarks the calling thread; returns the previous state. */
+    bool setActive(bool shouldBeActive) noexcept;
+}
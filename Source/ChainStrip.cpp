@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    Strip of the chain's modules, reordered by dragging.
+
+  ==============================================================================
+*/
+
+#include "ChainStrip.h"
+
+ChainStrip::Tile::Tile(const juce::String& n) : name(n) {
+    setBufferedToImage(true);
+    setInterceptsMouseClicks(false, false);
+    setOpaque(false);
+}
+
+void ChainStrip::Tile::paint(juce::Graphics& g) {
+    auto bounds = getLocalBounds().toFloat().reduced(2.f);
+
+    g.setColour(juce::Colours::darkslategrey);
+    g.fillRoundedRectangle(bounds, 4.f);
+    g.setColour(juce::Colours::white);
+    g.drawRoundedRectangle(bounds, 4.f, 1.f);
+
+    g.setFont(13.0f);
+    g.drawFittedText(name, getLocalBounds(), juce::Justification::centred, 1);
+}
+
+//==============================================================================
+ChainStrip::ChainStrip(const std::array<juce::String, numOptions>& n) : names(n) {
+    for (size_t option = 0; option < numOptions; ++option) {
+        for (size_t instance = 0; instance < numInstances; ++instance) {
+            auto name = instance == 0 ? names[option] : names[option] + " " + juce::String(instance + 1);
+            auto& tile = tiles[getTileIndex({ static_cast<DSP_Option>(option), instance })];
+            tile = std::make_unique<Tile>(name);
+            addChildComponent(*tile);
+        }
+    }
+
+    setMouseCursor(juce::MouseCursor::DraggingHandCursor);
+}
+
+void ChainStrip::setGraph(const DSP_Graph& newGraph) {
+    if (draggedTile != nullptr || newGraph == graph)
+        return;
+
+    graph = newGraph;
+    dragGraph = newGraph;
+    layoutTiles();
+}
+
+void ChainStrip::setBands(size_t newNumBands, std::uint32_t newFollowers) {
+    followers = newFollowers;
+
+    if (newNumBands == numBands)
+        return;
+
+    auto labelChanged = (newNumBands > 1) != (numBands > 1);
+    numBands = newNumBands;
+
+    if (shownBand >= numBands)
+        showBand(0);
+
+    if (labelChanged) {
+        layoutTiles();
+        repaint();
+    }
+}
+
+void ChainStrip::paint(juce::Graphics& g) {
+    g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+
+    if (numBands > 1) {
+        g.setColour(juce::Colours::white);
+        g.setFont(13.0f);
+        g.drawFittedText("B" + juce::String(shownBand + 1), getLocalBounds().withWidth(bandLabelWidth), juce::Justification::centred, 1);
+    }
+}
+
+void ChainStrip::resized() {
+    layoutTiles();
+}
+
+void ChainStrip::mouseDown(const juce::MouseEvent& e) {
+    auto slot = getSlotAt(e.x);
+
+    if (e.mods.isPopupMenu()) {
+        showSlotMenu(slot);
+        return;
+    }
+
+    if (slot >= graph.size())
+        return;
+
+    draggedSlot = graph[slot];
+    draggedTile = tiles[getTileIndex(draggedSlot)].get();
+    dragOffsetX = e.x - draggedTile->getX();
+    draggedTile->toFront(false);
+}
+
+void ChainStrip::mouseDrag(const juce::MouseEvent& e) {
+    if (draggedTile == nullptr)
+        return;
+
+    auto area = getSlotArea();
+    auto maxX = area.getRight() - draggedTile->getWidth();
+    draggedTile->setTopLeftPosition(juce::jlimit(area.getX(), juce::jmax(area.getX(), maxX), e.x - dragOffsetX), draggedTile->getY());
+
+    // Move the dragged module to the slot under its centre; the other tiles
+    // only shift when that slot changes.
+    auto slot = getSlotAt(draggedTile->getBounds().getCentreX());
+    auto from = dragGraph.indexOf(draggedSlot);
+
+    if (! from.has_value() || *from == slot)
+        return;
+
+    dragGraph.move(*from, slot);
+    layoutTiles();
+}
+
+void ChainStrip::mouseUp(const juce::MouseEvent&) {
+    if (draggedTile == nullptr)
+        return;
+
+    draggedTile = nullptr;
+    changeGraph(dragGraph);
+}
+
+void ChainStrip::showSlotMenu(size_t slot) {
+    juce::PopupMenu addMenu;
+    auto position = juce::jmin(slot + 1, graph.size());
+
+    for (size_t option = 0; option < numOptions; ++option) {
+        auto instance = graph.getFreeInstance(static_cast<DSP_Option>(option));
+
+        addMenu.addItem(names[option], instance.has_value() && ! graph.isFull(), false, [this, position, option, instance] {
+            auto newGraph = graph;
+
+            if (newGraph.insert(position, { static_cast<DSP_Option>(option), *instance }))
+                changeGraph(newGraph);
+        });
+    }
+
+    juce::PopupMenu menu;
+    menu.addSubMenu("Add After", addMenu);
+    menu.addItem("Remove", slot < graph.size(), false, [this, slot] {
+        auto newGraph = graph;
+
+        if (newGraph.remove(slot))
+            changeGraph(newGraph);
+    });
+
+    if (numBands > 1) {
+        juce::PopupMenu bandMenu;
+
+        for (size_t band = 0; band < numBands; ++band)
+            bandMenu.addItem("Band " + juce::String(band + 1), true, band == shownBand, [this, band] { showBand(band); });
+
+        auto band = shownBand;
+        auto isFollowing = ((followers >> band) & 1) != 0;
+
+        menu.addSeparator();
+        menu.addSubMenu("Show Band", bandMenu);
+        menu.addItem("Follow Band 1", band > 0, isFollowing, [this, band, isFollowing] {
+            if (! isFollowing && onBandFollowsFirst)
+                onBandFollowsFirst(band);
+        });
+    }
+
+    // The menu is dismissed if the strip goes first, so the callbacks never outlive it.
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this));
+}
+
+void ChainStrip::changeGraph(const DSP_Graph& newGraph) {
+    dragGraph = newGraph;
+    layoutTiles();
+
+    if (newGraph != graph) {
+        graph = newGraph;
+
+        if (onGraphChanged)
+            onGraphChanged(graph);
+    }
+}
+
+void ChainStrip::showBand(size_t band) {
+    if (band == shownBand)
+        return;
+
+    shownBand = band;
+    repaint();
+
+    if (onBandShown)
+        onBandShown(band);
+}
+
+juce::Rectangle<int> ChainStrip::getSlotArea() const {
+    return getLocalBounds().withTrimmedLeft(numBands > 1 ? bandLabelWidth : 0);
+}
+
+juce::Rectangle<int> ChainStrip::getSlotBounds(size_t slot) const {
+    auto area = getSlotArea();
+    auto slotWidth = area.getWidth() / static_cast<int>(juce::jmax<size_t>(1, dragGraph.size()));
+    return { area.getX() + static_cast<int>(slot) * slotWidth, 0, slotWidth, getHeight() };
+}
+
+size_t ChainStrip::getSlotAt(int x) const {
+    auto area = getSlotArea();
+    auto numSlots = static_cast<int>(juce::jmax<size_t>(1, dragGraph.size()));
+    auto slotWidth = juce::jmax(1, area.getWidth() / numSlots);
+    return static_cast<size_t>(juce::jlimit(0, numSlots - 1, (x - area.getX()) / slotWidth));
+}
+
+void ChainStrip::layoutTiles() {
+    // Only instances in the graph have a tile showing.
+    for (size_t option = 0; option < numOptions; ++option) {
+        for (size_t instance = 0; instance < numInstances; ++instance) {
+            DSP_Graph::Slot slot { static_cast<DSP_Option>(option), instance };
+            tiles[getTileIndex(slot)]->setVisible(dragGraph.contains(slot));
+        }
+    }
+
+    for (size_t slot = 0; slot < dragGraph.size(); ++slot) {
+        auto* tile = tiles[getTileIndex(dragGraph[slot])].get();
+
+        // The dragged tile follows the mouse until it's dropped.
+        if (tile == draggedTile)
+            tile->setSize(getSlotBounds(slot).getWidth(), getHeight());
+        else
+            tile->setBounds(getSlotBounds(slot));
+    }
+}
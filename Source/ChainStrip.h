@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    Strip of the chain's modules, reordered by dragging.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+/** One tile per slot of one band's graph, left to right in chain order.
+    Right-clicking a slot adds a module instance after it or removes it; in
+    split mode the menu also picks the band shown, labelled on the left, and
+    can set it back to following band 1.
+
+    Each tile is drawn once into its own cached image, so during a drag only
+    the moving tile and the area it uncovers are redrawn, and the others are
+    blitted when they shift to make room. Nothing runs between mouse events.
+    The new graph is reported once, on drop or menu choice.
+*/
+class ChainStrip  : public juce::Component
+{
+public:
+    using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+    using DSP_Graph = JucetutorialsAudioProcessor::DSP_Graph;
+    static constexpr size_t numOptions = static_cast<size_t>(DSP_Option::END_OF_LIST);
+    static constexpr size_t numInstances = JucetutorialsAudioProcessor::instancesPerModule;
+
+    /** names holds each module's label, indexed by DSP_Option. */
+    explicit ChainStrip(const std::array<juce::String, numOptions>& names);
+
+    /** Ignored during a drag; the dropped graph wins. */
+    void setGraph(const DSP_Graph& newGraph);
+
+    std::function<void(const DSP_Graph&)> onGraphChanged;
+
+    /** followers has bit b set when band b follows band 0. A band that's
+        gone takes the strip back to band 0, through onBandShown. */
+    void setBands(size_t newNumBands, std::uint32_t newFollowers);
+    size_t getShownBand() const { return shownBand; }
+
+    /** The owner answers with setGraph() for the band. */
+    std::function<void(size_t band)> onBandShown;
+    std::function<void(size_t band)> onBandFollowsFirst;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+    void mouseDown(const juce::MouseEvent&) override;
+    void mouseDrag(const juce::MouseEvent&) override;
+    void mouseUp(const juce::MouseEvent&) override;
+
+private:
+    class Tile  : public juce::Component
+    {
+    public:
+        explicit Tile(const juce::String& name);
+        void paint(juce::Graphics&) override;
+
+    private:
+        juce::String name;
+    };
+
+    static constexpr size_t numTiles = numOptions * numInstances;
+
+    static size_t getTileIndex(const DSP_Graph::Slot& slot) {
+        return static_cast<size_t>(slot.option) * numInstances + slot.instance;
+    }
+
+    static constexpr int bandLabelWidth = 28;
+
+    juce::Rectangle<int> getSlotArea() const;
+    juce::Rectangle<int> getSlotBounds(size_t slot) const;
+    size_t getSlotAt(int x) const;
+    void layoutTiles();
+    void showSlotMenu(size_t slot);
+    void changeGraph(const DSP_Graph& newGraph);
+    void showBand(size_t band);
+
+    std::array<std::unique_ptr<Tile>, numTiles> tiles;     // indexed by getTileIndex()
+    std::array<juce::String, numOptions> names;
+    DSP_Graph graph {};
+    DSP_Graph dragGraph {};     // the graph shown while dragging
+
+    size_t numBands = 1;
+    size_t shownBand = 0;
+    std::uint32_t followers = 0;
+
+    Tile* draggedTile = nullptr;
+    DSP_Graph::Slot draggedSlot {};
+    int dragOffsetX = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChainStrip)
+};
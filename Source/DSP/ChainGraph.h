@@ -0,0 +1,359 @@
+/*
+  ==============================================================================
+
+    A chain of any length built from pooled module instances, packed into a
+    single word so it can be handed between threads atomically.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+/** Up to MaxSlots slots, each naming a module type and which of that type's
+    NumInstances pooled instances runs there. A type can appear more than
+    once, or not at all, but no instance runs in two slots.
+
+    The slots live in a fixed array, so editing the chain never allocates and
+    running it walks one contiguous block. Like PackedOrder, the whole graph
+    packs into one 64-bit word that the audio thread picks up with a single
+    atomic load.
+*/
+template<typename Option, size_t NumOptions, size_t NumInstances, size_t MaxSlots>
+class ChainGraph
+{
+public:
+    struct Slot {
+        using OptionType = Option;
+        Option option {};
+        size_t instance = 0;
+        constexpr bool operator==(const Slot&) const = default;
+    };
+
+    static constexpr size_t maxSlots = MaxSlots;
+    static constexpr size_t numOptions = NumOptions;
+    static constexpr size_t numInstances = NumInstances;
+
+    /** Instance 0 of each module in the order, one slot each. */
+    template<size_t NumSlots>
+    static constexpr ChainGraph fromOrder(const std::array<Option, NumSlots>& order) {
+        static_assert(NumSlots <= MaxSlots, "Order is longer than the graph");
+
+        ChainGraph graph;
+
+        for (auto option : order)
+            graph.slots[graph.numSlots++] = { option, 0 };
+
+        return graph;
+    }
+
+    constexpr size_t size() const noexcept { return numSlots; }
+    constexpr bool isEmpty() const noexcept { return numSlots == 0; }
+    constexpr bool isFull() const noexcept { return numSlots == MaxSlots; }
+
+    constexpr const Slot& operator[](size_t index) const noexcept { return slots[index]; }
+    constexpr const Slot* begin() const noexcept { return slots.data(); }
+    constexpr const Slot* end() const noexcept { return slots.data() + numSlots; }
+
+    constexpr std::optional<size_t> indexOf(const Slot& slot) const noexcept {
+        for (size_t i = 0; i < numSlots; ++i)
+            if (slots[i] == slot)
+                return i;
+
+        return {};
+    }
+
+    constexpr bool contains(const Slot& slot) const noexcept { return indexOf(slot).has_value(); }
+
+    /** The lowest instance of the option that isn't in the chain, if any is left. */
+    constexpr std::optional<size_t> getFreeInstance(Option option) const noexcept {
+        for (size_t instance = 0; instance < NumInstances; ++instance)
+            if (! contains({ option, instance }))
+                return instance;
+
+        return {};
+    }
+
+    /** The edits return false, and leave the graph as it was, when they
+        would make it invalid or the position is out of range. */
+    constexpr bool insert(size_t position, const Slot& slot) noexcept {
+        if (isFull() || position > numSlots || ! isValidSlot(slot) || contains(slot))
+            return false;
+
+        for (auto i = numSlots; i > position; --i)
+            slots[i] = slots[i - 1];
+
+        slots[position] = slot;
+        ++numSlots;
+        return true;
+    }
+
+    constexpr bool remove(size_t position) noexcept {
+        if (position >= numSlots)
+            return false;
+
+        for (auto i = position + 1; i < numSlots; ++i)
+            slots[i - 1] = slots[i];
+
+        slots[--numSlots] = {};
+        return true;
+    }
+
+    constexpr bool move(size_t from, size_t to) noexcept {
+        if (from >= numSlots || to >= numSlots)
+            return false;
+
+        if (from < to)
+            std::rotate(slots.begin() + from, slots.begin() + from + 1, slots.begin() + to + 1);
+        else
+            std::rotate(slots.begin() + to, slots.begin() + from, slots.begin() + from + 1);
+
+        return true;
+    }
+
+    /** Set when the chain is instance 0 of every module once: a plain
+        ordering, which the processor has a specialised chain for. */
+    constexpr std::optional<std::array<Option, NumOptions>> getOrder() const noexcept {
+        if (numSlots != NumOptions)
+            return {};
+
+        std::array<Option, NumOptions> order {};
+        std::array<bool, NumOptions> seen {};
+
+        for (size_t i = 0; i < numSlots; ++i) {
+            auto index = static_cast<size_t>(slots[i].option);
+
+            if (slots[i].instance != 0 || index >= NumOptions || seen[index])
+                return {};
+
+            seen[index] = true;
+            order[i] = slots[i].option;
+        }
+
+        return order;
+    }
+
+    constexpr bool isValid() const noexcept {
+        for (size_t i = 0; i < numSlots; ++i) {
+            if (! isValidSlot(slots[i]))
+                return false;
+
+            for (size_t j = 0; j < i; ++j)
+                if (slots[j] == slots[i])
+                    return false;
+        }
+
+        return true;
+    }
+
+    constexpr std::uint64_t pack() const noexcept {
+        auto word = static_cast<std::uint64_t>(numSlots);
+
+        for (size_t i = 0; i < numSlots; ++i) {
+            auto bits = static_cast<std::uint64_t>(slots[i].option) | (static_cast<std::uint64_t>(slots[i].instance) << optionBits);
+            word |= (bits & slotMask) << (lengthBits + i * bitsPerSlot);
+        }
+
+        return word;
+    }
+
+    /** A word from outside, like a saved state, may not unpack to a valid graph: check isValid(). */
+    static constexpr ChainGraph unpack(std::uint64_t word) noexcept {
+        ChainGraph graph;
+        graph.numSlots = std::min(static_cast<size_t>(word & lengthMask), MaxSlots);
+
+        for (size_t i = 0; i < graph.numSlots; ++i) {
+            auto bits = (word >> (lengthBits + i * bitsPerSlot)) & slotMask;
+            graph.slots[i] = { static_cast<Option>(bits & optionMask), static_cast<size_t>(bits >> optionBits) };
+        }
+
+        return graph;
+    }
+
+    constexpr bool operator==(const ChainGraph& other) const noexcept {
+        if (numSlots != other.numSlots)
+            return false;
+
+        for (size_t i = 0; i < numSlots; ++i)
+            if (slots[i] != other.slots[i])
+                return false;
+
+        return true;
+    }
+
+private:
+    static constexpr size_t optionBits = static_cast<size_t>(std::bit_width(NumOptions - 1));
+    static constexpr size_t instanceBits = static_cast<size_t>(std::bit_width(NumInstances - 1));
+    static constexpr size_t bitsPerSlot = optionBits + instanceBits;
+    static constexpr size_t lengthBits = static_cast<size_t>(std::bit_width(MaxSlots));
+
+    static constexpr std::uint64_t optionMask = (std::uint64_t(1) << optionBits) - 1;
+    static constexpr std::uint64_t slotMask = (std::uint64_t(1) << bitsPerSlot) - 1;
+    static constexpr std::uint64_t lengthMask = (std::uint64_t(1) << lengthBits) - 1;
+
+    static_assert(lengthBits + MaxSlots * bitsPerSlot <= 64, "Graph doesn't fit in one word");
+
+    static constexpr bool isValidSlot(const Slot& slot) noexcept {
+        return static_cast<size_t>(slot.option) < NumOptions && slot.instance < NumInstances;
+    }
+
+    std::array<Slot, MaxSlots> slots {};
+    size_t numSlots = 0;
+};
+
+/** The order to run the instances of several graphs in, one graph per band,
+    so that every instance runs once over all the bands that use it.
+
+    Bands sharing an instance must agree on the order of the instances they
+    share, so that one order of the steps fits every band's graph; bands can
+    have different instances, or the same ones in any order as long as they
+    don't share them. The steps follow band 0's graph wherever the others
+    allow it.
+*/
+template<typename Graph, size_t MaxBands>
+class ChainSchedule
+{
+public:
+    using Slot = typename Graph::Slot;
+
+    struct Step {
+        Slot slot {};
+        std::uint32_t bands = 0;    // bit b set when band b runs the instance here
+        constexpr bool operator==(const Step&) const = default;
+    };
+
+    /** Empty when the bands disagree on the order of instances they share,
+        or use more than Graph::maxSlots instances between them.
+    */
+    static constexpr std::optional<ChainSchedule> build(const std::array<Graph, MaxBands>& graphs, size_t numBands) noexcept {
+        std::array<std::uint32_t, numNodes> bands {};
+        std::array<std::uint64_t, numNodes> successors {};
+        std::array<size_t, numNodes> numPredecessors {};
+        std::array<size_t, numNodes> firstSeen {};
+        size_t numSeen = 0;
+
+        for (size_t band = 0; band < std::min(numBands, MaxBands); ++band) {
+            const auto& graph = graphs[band];
+
+            for (size_t i = 0; i < graph.size(); ++i) {
+                auto node = getNode(graph[i]);
+
+                if (bands[node] == 0)
+                    firstSeen[node] = numSeen++;
+
+                bands[node] |= std::uint32_t(1) << band;
+
+                if (i == 0)
+                    continue;
+
+                auto previous = getNode(graph[i - 1]);
+
+                if (((successors[previous] >> node) & 1) == 0) {
+                    successors[previous] |= std::uint64_t(1) << node;
+                    ++numPredecessors[node];
+                }
+            }
+        }
+
+        if (numSeen > Graph::maxSlots)
+            return {};
+
+        // Each step takes the instance first seen among those nothing is waiting on.
+        ChainSchedule schedule;
+        std::array<bool, numNodes> done {};
+
+        while (schedule.numSteps < numSeen) {
+            auto next = numNodes;
+
+            for (size_t node = 0; node < numNodes; ++node)
+                if (bands[node] != 0 && ! done[node] && numPredecessors[node] == 0 && (next == numNodes || firstSeen[node] < firstSeen[next]))
+                    next = node;
+
+            // Everything left waits on something else: two bands disagree.
+            if (next == numNodes)
+                return {};
+
+            done[next] = true;
+            schedule.steps[schedule.numSteps++] = { getSlot(next), bands[next] };
+
+            for (size_t node = 0; node < numNodes; ++node)
+                if ((successors[next] >> node) & 1)
+                    --numPredecessors[node];
+        }
+
+        return schedule;
+    }
+
+    constexpr size_t size() const noexcept { return numSteps; }
+    constexpr const Step& operator[](size_t index) const noexcept { return steps[index]; }
+    constexpr const Step* begin() const noexcept { return steps.data(); }
+    constexpr const Step* end() const noexcept { return steps.data() + numSteps; }
+
+    /** The bands running the instance, or 0 when none does. */
+    constexpr std::uint32_t getBands(const Slot& slot) const noexcept {
+        for (size_t i = 0; i < numSteps; ++i)
+            if (steps[i].slot == slot)
+                return steps[i].bands;
+
+        return 0;
+    }
+
+private:
+    static constexpr size_t numNodes = Graph::numOptions * Graph::numInstances;
+    static_assert(numNodes <= 64, "Successors don't fit in one word");
+    static_assert(MaxBands <= 32, "Bands don't fit in one word");
+
+    static constexpr size_t getNode(const Slot& slot) noexcept {
+        return static_cast<size_t>(slot.option) * Graph::numInstances + slot.instance;
+    }
+
+    static constexpr Slot getSlot(size_t node) noexcept {
+        return { static_cast<typename Graph::Slot::OptionType>(node / Graph::numInstances), node % Graph::numInstances };
+    }
+
+    std::array<Step, Graph::maxSlots> steps {};
+    size_t numSteps = 0;
+};
+
+namespace ChainGraphChecks
+{
+    using Graph = ChainGraph<size_t, 6, 2, 8>;
+
+    constexpr Graph makeGraph() {
+        auto graph = Graph::fromOrder(std::array<size_t, 3> { 4, 2, 0 });
+        graph.insert(1, { 2, 1 });
+        graph.insert(4, { 5, 0 });
+        return graph;
+    }
+
+    static_assert(Graph::unpack(makeGraph().pack()) == makeGraph());
+    static_assert(makeGraph().isValid() && makeGraph().size() == 5);
+    static_assert(! makeGraph().getOrder().has_value());
+    static_assert(Graph::fromOrder(std::array<size_t, 6> { 5, 4, 3, 2, 1, 0 }).getOrder().has_value());
+    static_assert(! Graph::unpack(Graph::fromOrder(std::array<size_t, 2> { 1, 1 }).pack()).isValid());
+
+    using Schedule = ChainSchedule<Graph, 3>;
+
+    // Band 1 leaves out 1, band 2 runs only 1: each shared instance still runs once.
+    constexpr auto schedule = Schedule::build({ Graph::fromOrder(std::array<size_t, 3> { 0, 1, 2 }),
+                                                Graph::fromOrder(std::array<size_t, 2> { 0, 2 }),
+                                                Graph::fromOrder(std::array<size_t, 1> { 1 }) },
+                                              3);
+
+    static_assert(schedule.has_value() && schedule->size() == 3);
+    static_assert((*schedule)[0] == Schedule::Step { { 0, 0 }, 0b011 });
+    static_assert((*schedule)[1] == Schedule::Step { { 1, 0 }, 0b101 });
+    static_assert((*schedule)[2] == Schedule::Step { { 2, 0 }, 0b011 });
+
+    // Two bands running the same two instances in opposite orders can't share them.
+    static_assert(! Schedule::build({ Graph::fromOrder(std::array<size_t, 2> { 0, 1 }),
+                                      Graph::fromOrder(std::array<size_t, 2> { 1, 0 }),
+                                      Graph {} },
+                                    2).has_value());
+}
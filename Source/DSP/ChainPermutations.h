@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    Compile-time helpers for enumerating the orderings of the effect chain.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace ChainPermutations
+{
+    constexpr size_t factorial(size_t n) {
+        return n <= 1 ? 1 : n * factorial(n - 1);
+    }
+
+    // Returns the index-th lexicographic permutation of { 0, 1, ..., N - 1 }.
+    template<size_t N>
+    constexpr std::array<size_t, N> getPermutation(size_t index) {
+        std::array<size_t, N> remaining{};
+
+        for (size_t i = 0; i < N; ++i)
+            remaining[i] = i;
+
+        std::array<size_t, N> permutation{};
+        auto numRemaining = N;
+
+        for (size_t i = 0; i < N; ++i) {
+            auto stride = factorial(N - 1 - i);
+            auto pick = index / stride;
+            index %= stride;
+
+            permutation[i] = remaining[pick];
+
+            for (auto j = pick; j + 1 < numRemaining; ++j)
+                remaining[j] = remaining[j + 1];
+
+            --numRemaining;
+        }
+
+        return permutation;
+    }
+
+    // Inverse of getPermutation(). Returns factorial(N) if the input isn't a
+    // permutation of { 0, 1, ..., N - 1 }, i.e. if any value repeats.
+    template<size_t N>
+    constexpr size_t getPermutationIndex(const std::array<size_t, N>& permutation) {
+        std::array<bool, N> used{};
+        size_t index = 0;
+
+        for (size_t i = 0; i < N; ++i) {
+            auto value = permutation[i];
+
+            if (value >= N || used[value])
+                return factorial(N);
+
+            size_t numSmallerUnused = 0;
+
+            for (size_t v = 0; v < value; ++v)
+                if (! used[v])
+                    ++numSmallerUnused;
+
+            index += numSmallerUnused * factorial(N - 1 - i);
+            used[value] = true;
+        }
+
+        return index;
+    }
+
+    template<size_t N, size_t Index>
+    inline constexpr auto permutation = getPermutation<N>(Index);
+
+    static_assert(getPermutationIndex<4>(getPermutation<4>(0)) == 0);
+    static_assert(getPermutationIndex<4>(getPermutation<4>(17)) == 17);
+    static_assert(getPermutationIndex<4>({ 3, 2, 1, 0 }) == factorial(4) - 1);
+    static_assert(getPermutationIndex<4>({ 1, 1, 2, 3 }) == factorial(4));
+}
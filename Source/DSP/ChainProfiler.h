@@ -0,0 +1,285 @@
+/*
+  ==============================================================================
+
+    Cycle-counter timings of the audio thread's stages, for profiling builds.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <bit>
+
+// Off unless the build defines it: without it every probe compiles to nothing.
+#ifndef JUCETUTORIALS_PROFILING
+ #define JUCETUTORIALS_PROFILING 0
+#endif
+
+#if JUCETUTORIALS_PROFILING && JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+/** Times the stages of processBlock with the CPU's cycle counter: the order
+    and reload handoff, the parameter update, and each slot of the chain.
+
+    Every stage has a histogram with four buckets per octave of cycles, plus
+    its count, total and maximum. Like LevelMeter, the audio thread is the
+    only writer and publishes through relaxed atomics, so readers never
+    block it. While tracing, each timing is also pushed to a single-reader
+    FIFO of events for export; events that don't fit are counted and dropped.
+
+    With JUCETUTORIALS_PROFILING off the class has no data, ScopedTimer is
+    empty, and every call is an inline no-op.
+*/
+class ChainProfiler
+{
+public:
+    static constexpr bool isEnabled = JUCETUTORIALS_PROFILING != 0;
+    static constexpr size_t maxSlots = 8;
+
+    enum class Stage
+    {
+        Block,          // the whole of processBlock
+        Order,          // tempo, reload and chain graph handoff from other threads
+        Parameters,     // reading the parameters and updating the modules
+        Slot0           // followed by one stage per slot of the chain
+    };
+
+    static constexpr size_t numStages = static_cast<size_t>(Stage::Slot0) + maxSlots;
+
+    static Stage getSlotStage(size_t slot) noexcept {
+        jassert(slot < maxSlots);
+        return static_cast<Stage>(static_cast<size_t>(Stage::Slot0) + slot);
+    }
+
+    static juce::String getStageName(Stage stage) {
+        switch (stage) {
+        case Stage::Block:      return "Block";
+        case Stage::Order:      return "Order";
+        case Stage::Parameters: return "Parameters";
+        case Stage::Slot0:      break;
+        }
+
+        return "Slot " + juce::String(static_cast<int>(stage) - static_cast<int>(Stage::Slot0));
+    }
+
+    struct Summary {
+        std::uint64_t count = 0, totalCycles = 0, maxCycles = 0;
+        double p50Cycles = 0, p99Cycles = 0;
+    };
+
+    struct Event {
+        std::uint64_t startCycles = 0, endCycles = 0;
+        Stage stage = Stage::Block;
+        int module = -1;    // the DSP_Option in a slot, -1 for the other stages
+    };
+
+    static std::uint64_t readCycles() noexcept {
+       #if ! JUCETUTORIALS_PROFILING
+        return 0;
+       #elif JUCE_INTEL
+        return __rdtsc();
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        std::uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+       #else
+        return static_cast<std::uint64_t>(juce::Time::getHighResolutionTicks());
+       #endif
+    }
+
+    /** Measured once, on first use, where the counter has no fixed frequency. */
+    static double getCyclesPerSecond() {
+        static const double cyclesPerSecond = measureCyclesPerSecond();
+        return cyclesPerSecond;
+    }
+
+    static double cyclesToMicros(double cycles) { return cycles * 1.0e6 / getCyclesPerSecond(); }
+
+  #if JUCETUTORIALS_PROFILING
+    ChainProfiler() : events(eventCapacity) {}
+
+    /** Audio thread only. */
+    void record(Stage stage, int module, std::uint64_t startCycles, std::uint64_t endCycles) noexcept {
+        if (stage == Stage::Block && resetRequested.exchange(false, std::memory_order_relaxed))
+            clearHistograms();
+
+        auto& histogram = histograms[static_cast<size_t>(stage)];
+        auto cycles = endCycles - startCycles;
+
+        bump(histogram.buckets[getBucket(cycles)], 1);
+        bump(histogram.count, 1);
+        bump(histogram.totalCycles, cycles);
+
+        if (cycles > histogram.maxCycles.load(std::memory_order_relaxed))
+            histogram.maxCycles.store(cycles, std::memory_order_relaxed);
+
+        if (! tracing.load(std::memory_order_relaxed))
+            return;
+
+        if (eventFifo.getFreeSpace() == 0) {
+            bump(droppedEvents, 1);
+            return;
+        }
+
+        auto scope = eventFifo.write(1);
+        events[static_cast<size_t>(scope.startIndex1)] = { startCycles, endCycles, stage, module };
+    }
+
+    /** Any thread. */
+    Summary getSummary(Stage stage) const noexcept {
+        const auto& histogram = histograms[static_cast<size_t>(stage)];
+
+        Summary summary;
+        summary.count = histogram.count.load(std::memory_order_relaxed);
+        summary.totalCycles = histogram.totalCycles.load(std::memory_order_relaxed);
+        summary.maxCycles = histogram.maxCycles.load(std::memory_order_relaxed);
+
+        std::array<std::uint64_t, numBuckets> counts;
+        std::uint64_t numCounted = 0;
+
+        for (size_t i = 0; i < numBuckets; ++i)
+            numCounted += counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+
+        summary.p50Cycles = getPercentile(counts, numCounted, 0.5);
+        summary.p99Cycles = getPercentile(counts, numCounted, 0.99);
+        return summary;
+    }
+
+    /** Any thread; the histograms are cleared at the start of the next block. */
+    void reset() noexcept { resetRequested.store(true, std::memory_order_relaxed); }
+
+    /** Any thread. Events are only collected while tracing. */
+    void setTracing(bool shouldTrace) noexcept { tracing.store(shouldTrace, std::memory_order_relaxed); }
+    std::uint64_t getNumDroppedEvents() const noexcept { return droppedEvents.load(std::memory_order_relaxed); }
+
+    /** One reader thread at a time: hands every queued event to the callback. */
+    template<typename Callback>
+    void readEvents(Callback&& callback) {
+        auto scope = eventFifo.read(eventFifo.getNumReady());
+        scope.forEach([&](int index) { callback(events[static_cast<size_t>(index)]); });
+    }
+
+    struct ScopedTimer {
+        ScopedTimer(ChainProfiler& p, Stage s, int m = -1) noexcept : profiler(p), stage(s), module(m) {}
+        ~ScopedTimer() { profiler.record(stage, module, startCycles, readCycles()); }
+
+        ChainProfiler& profiler;
+        Stage stage;
+        int module;
+        std::uint64_t startCycles = readCycles();
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+  #else
+    void record(Stage, int, std::uint64_t, std::uint64_t) noexcept {}
+    Summary getSummary(Stage) const noexcept { return {}; }
+    void reset() noexcept {}
+    void setTracing(bool) noexcept {}
+    std::uint64_t getNumDroppedEvents() const noexcept { return 0; }
+
+    template<typename Callback>
+    void readEvents(Callback&&) {}
+
+    struct ScopedTimer {
+        ScopedTimer(ChainProfiler&, Stage, int = -1) noexcept {}
+    };
+  #endif
+
+private:
+    static double measureCyclesPerSecond() {
+       #if ! JUCETUTORIALS_PROFILING
+        return 1.0;
+       #elif JUCE_INTEL
+        // Spin against the high resolution clock for a few milliseconds.
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        auto startCycles = readCycles();
+        auto endTicks = startTicks + juce::Time::secondsToHighResolutionTicks(0.02);
+
+        while (juce::Time::getHighResolutionTicks() < endTicks) {}
+
+        auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        return static_cast<double>(readCycles() - startCycles) / seconds;
+       #elif JUCE_ARM && JUCE_64BIT && ! JUCE_MSVC
+        std::uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        return static_cast<double>(frequency);
+       #else
+        return static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+       #endif
+    }
+
+  #if JUCETUTORIALS_PROFILING
+    // Four buckets per octave, up to 2^40 cycles.
+    static constexpr size_t bucketsPerOctave = 4;
+    static constexpr size_t numOctaves = 40;
+    static constexpr size_t numBuckets = numOctaves * bucketsPerOctave;
+    static constexpr int eventCapacity = 1 << 16;
+
+    struct Histogram {
+        std::array<std::atomic<std::uint32_t>, numBuckets> buckets {};
+        std::atomic<std::uint64_t> count { 0 }, totalCycles { 0 }, maxCycles { 0 };
+    };
+
+    // The audio thread is the only writer, so a plain load and store is enough.
+    template<typename T>
+    static void bump(std::atomic<T>& value, std::type_identity_t<T> amount) noexcept {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static size_t getBucket(std::uint64_t cycles) noexcept {
+        if (cycles < bucketsPerOctave)
+            return static_cast<size_t>(cycles);
+
+        auto octave = static_cast<size_t>(std::bit_width(cycles) - 1);
+        auto fraction = static_cast<size_t>(cycles >> (octave - 2)) & (bucketsPerOctave - 1);
+        return juce::jmin(numBuckets - 1, octave * bucketsPerOctave + fraction);
+    }
+
+    static double getBucketCentre(size_t bucket) noexcept {
+        if (bucket < bucketsPerOctave)
+            return static_cast<double>(bucket);
+
+        auto octave = bucket / bucketsPerOctave;
+        auto fraction = static_cast<double>(bucket % bucketsPerOctave) + 0.5;
+        return std::ldexp(1.0 + fraction / bucketsPerOctave, static_cast<int>(octave));
+    }
+
+    static double getPercentile(const std::array<std::uint64_t, numBuckets>& counts, std::uint64_t total, double p) noexcept {
+        if (total == 0)
+            return 0;
+
+        auto rank = static_cast<std::uint64_t>(std::ceil(p * static_cast<double>(total)));
+        std::uint64_t seen = 0;
+
+        for (size_t i = 0; i < numBuckets; ++i)
+            if ((seen += counts[i]) >= rank)
+                return getBucketCentre(i);
+
+        return getBucketCentre(numBuckets - 1);
+    }
+
+    void clearHistograms() noexcept {
+        for (auto& histogram : histograms) {
+            for (auto& bucket : histogram.buckets)
+                bucket.store(0, std::memory_order_relaxed);
+
+            histogram.count.store(0, std::memory_order_relaxed);
+            histogram.totalCycles.store(0, std::memory_order_relaxed);
+            histogram.maxCycles.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    std::array<Histogram, numStages> histograms;
+    std::atomic<bool> resetRequested { false }, tracing { false };
+    std::atomic<std::uint64_t> droppedEvents { 0 };
+
+    juce::AbstractFifo eventFifo { eventCapacity };
+    std::vector<Event> events;
+  #endif
+};
@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    Moves channels in and out of SIMD lanes for the multichannel modules.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** The modules that keep each channel's state in its own SIMD lane process
+    groups of SIMDRegister<float>::size() channels, interleaved sample by
+    sample: group g carries channels g * numLanes onwards.
+
+    When a block doesn't fill its last group, the spare lanes shadow the
+    group's first channel. The state of channels left out of the block, like
+    the others of a mono-collapsed one, then stays in step with the first
+    channel's, so they can take over from it without a jump.
+*/
+namespace ChannelLanes
+{
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    /** Copies one group's channels of the block into its lanes. */
+    inline void interleave(const juce::dsp::AudioBlock<const float>& block, size_t group, SIMDFloat* samples) noexcept {
+        auto* lanes = reinterpret_cast<float*>(samples);
+        auto numSamples = block.getNumSamples();
+        auto firstChannel = group * numLanes;
+        auto numGroupChannels = juce::jmin(numLanes, block.getNumChannels() - firstChannel);
+
+        for (size_t lane = 0; lane < numLanes; ++lane) {
+            auto* src = block.getChannelPointer(firstChannel + (lane < numGroupChannels ? lane : 0));
+
+            for (size_t i = 0; i < numSamples; ++i)
+                lanes[i * numLanes + lane] = src[i];
+        }
+    }
+
+    /** Copies one group's lanes back to its channels of the block; spare lanes are dropped. */
+    inline void deinterleave(const SIMDFloat* samples, size_t group, const juce::dsp::AudioBlock<float>& block) noexcept {
+        auto* lanes = reinterpret_cast<const float*>(samples);
+        auto numSamples = block.getNumSamples();
+        auto firstChannel = group * numLanes;
+        auto numGroupChannels = juce::jmin(numLanes, block.getNumChannels() - firstChannel);
+
+        for (size_t lane = 0; lane < numGroupChannels; ++lane) {
+            auto* dst = block.getChannelPointer(firstChannel + lane);
+
+            for (size_t i = 0; i < numSamples; ++i)
+                dst[i] = lanes[i * numLanes + lane];
+        }
+    }
+}
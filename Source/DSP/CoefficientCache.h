@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Fixed-size cache of filter coefficients keyed on quantised settings.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Open-addressing hash table from a 32-bit key to a coefficient set.
+
+    All its storage is allocated up front, and it belongs to one thread:
+    lookups never allocate, lock or wait. A miss computes the value and
+    stores it in the first free slot of a short probe sequence, or over the
+    entry at the key's home slot once the sequence is full, so the cache
+    keeps working as a most-recently-used set when the settings wander.
+*/
+template<typename Value, size_t Capacity = 4096>
+class CoefficientCache
+{
+public:
+    static_assert(juce::isPowerOfTwo(Capacity));
+
+    CoefficientCache() : entries(Capacity) {}
+
+    void clear() {
+        for (auto& entry : entries)
+            entry.used = false;
+
+        numHits = numMisses = 0;
+    }
+
+    /** Returns the cached value for key, calling compute() to fill it on a miss. */
+    template<typename Compute>
+    const Value& get(std::uint32_t key, Compute&& compute) {
+        auto home = getHomeSlot(key);
+
+        for (size_t probe = 0; probe < maxProbes; ++probe) {
+            auto& entry = entries[(home + probe) & (Capacity - 1)];
+
+            if (! entry.used) {
+                ++numMisses;
+                return store(entry, key, compute);
+            }
+
+            if (entry.key == key) {
+                ++numHits;
+                return entry.value;
+            }
+        }
+
+        ++numMisses;
+        return store(entries[home], key, compute);
+    }
+
+    size_t getAllocatedBytes() const noexcept { return entries.capacity() * sizeof(Entry); }
+
+    std::uint64_t getNumHits() const noexcept { return numHits; }
+    std::uint64_t getNumMisses() const noexcept { return numMisses; }
+
+private:
+    static constexpr size_t maxProbes = 8;
+
+    struct Entry {
+        std::uint32_t key = 0;
+        bool used = false;
+        Value value {};
+    };
+
+    static size_t getHomeSlot(std::uint32_t key) noexcept {
+        // Fibonacci hashing: keys of neighbouring settings spread across the table.
+        return static_cast<size_t>((key * 0x9e3779b1u) >> (32 - juce::findHighestSetBit(static_cast<juce::uint32>(Capacity))));
+    }
+
+    template<typename Compute>
+    const Value& store(Entry& entry, std::uint32_t key, Compute&& compute) {
+        entry.key = key;
+        entry.used = true;
+        entry.value = compute();
+        return entry.value;
+    }
+
+    std::vector<Entry> entries;
+    std::uint64_t numHits = 0, numMisses = 0;
+};
@@ -0,0 +1,184 @@
+/*
+  ==============================================================================
+
+    Linkwitz-Riley band splitter that runs a channel's bands in SIMD lanes.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Splits every channel into 2 to maxBands bands with 4th-order
+    Linkwitz-Riley crossovers, arranged like SimpleMultiBandComp's: each
+    crossover splits the highest band so far in two, and the bands below it
+    go through the allpass the split adds, so the bands sum back flat.
+
+    Every band is then the input through one stage per crossover, a low-pass,
+    high-pass or allpass, so all the bands of a channel run side by side in
+    the lanes of one SIMDRegister, each lane with its own coefficients.
+    Band b of channel c is written to channel b * numChannels + c.
+*/
+class CrossoverSplitter
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+    static constexpr size_t maxBands = 4;
+    static constexpr size_t numCrossovers = maxBands - 1;
+
+    static_assert(maxBands <= numLanes, "Every band needs a lane");
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, 1, maximumBlockSize);
+        state.resize(numChannels);
+
+        updateCoefficients();
+        reset();
+    }
+
+    void reset() {
+        for (auto& s : state)
+            s = {};
+    }
+
+    /** Crossovers past numBands - 1 are ignored. Each is kept above the one
+        before it and below Nyquist. */
+    void setCrossovers(size_t newNumBands, const std::array<float, numCrossovers>& newFrequenciesHz) {
+        newNumBands = juce::jlimit<size_t>(2, maxBands, newNumBands);
+
+        if (newNumBands == numBands && newFrequenciesHz == frequenciesHz)
+            return;
+
+        numBands = newNumBands;
+        frequenciesHz = newFrequenciesHz;
+        updateCoefficients();
+    }
+
+    size_t getNumBands() const noexcept { return numBands; }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return interleaved.getNumChannels() * interleaved.getNumSamples() * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State);
+    }
+
+    /** bands needs numBands times as many channels as input. */
+    void process(const juce::dsp::AudioBlock<float>& input, const juce::dsp::AudioBlock<float>& bands) noexcept {
+        auto numSamples = input.getNumSamples();
+        auto numBlockChannels = input.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+        jassert(bands.getNumChannels() >= numBlockChannels * numBands);
+
+        auto* samples = interleaved.getChannelPointer(0);
+        auto* lanes = reinterpret_cast<float*>(samples);
+
+        for (size_t ch = 0; ch < numBlockChannels; ++ch) {
+            auto* src = input.getChannelPointer(ch);
+
+            // Two biquads per crossover, unrolled for each band count.
+            switch (numBands) {
+            case 2:  processChannel<2>(src, samples, numSamples, state[ch]); break;
+            case 3:  processChannel<4>(src, samples, numSamples, state[ch]); break;
+            default: processChannel<6>(src, samples, numSamples, state[ch]); break;
+            }
+
+            for (size_t band = 0; band < numBands; ++band) {
+                auto* dst = bands.getChannelPointer(band * numBlockChannels + ch);
+
+                for (size_t i = 0; i < numSamples; ++i)
+                    dst[i] = lanes[i * numLanes + band];
+            }
+        }
+    }
+
+private:
+    static constexpr size_t maxSections = 2 * numCrossovers;
+
+    struct Section {
+        SIMDFloat b0 = SIMDFloat::expand(1.f), b1 = SIMDFloat::expand(0.f), b2 = SIMDFloat::expand(0.f);
+        SIMDFloat a1 = SIMDFloat::expand(0.f), a2 = SIMDFloat::expand(0.f);
+
+        void setLane(size_t lane, const std::array<float, 6>& c) {
+            auto a0Inv = 1.f / c[3];
+            b0.set(lane, c[0] * a0Inv);
+            b1.set(lane, c[1] * a0Inv);
+            b2.set(lane, c[2] * a0Inv);
+            a1.set(lane, c[4] * a0Inv);
+            a2.set(lane, c[5] * a0Inv);
+        }
+    };
+
+    struct State {
+        std::array<SIMDFloat, maxSections> z1 {}, z2 {};
+    };
+
+    template<size_t NumSections>
+    void processChannel(const float* input, SIMDFloat* output, size_t numSamples, State& s) noexcept {
+        auto z1 = s.z1, z2 = s.z2;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            auto x = SIMDFloat::expand(input[i]);
+
+            for (size_t k = 0; k < NumSections; ++k) {
+                const auto& c = sections[k];
+                auto y = c.b0 * x + z1[k];
+                z1[k] = c.b1 * x - c.a1 * y + z2[k];
+                z2[k] = c.b2 * x - c.a2 * y;
+                x = y;
+            }
+
+            output[i] = x;
+        }
+
+        s.z1 = z1;
+        s.z2 = z2;
+    }
+
+    void updateCoefficients() {
+        using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+        constexpr std::array<float, 6> identity { 1.f, 0.f, 0.f, 1.f, 0.f, 0.f };
+        const auto q = juce::MathConstants<float>::sqrt2 * 0.5f;
+
+        auto maxFrequency = static_cast<float>(sampleRate * 0.45);
+        auto lowest = 20.f;
+
+        for (size_t k = 0; k < numCrossovers; ++k) {
+            auto frequency = juce::jlimit(lowest, juce::jmax(lowest, maxFrequency), frequenciesHz[k]);
+            lowest = frequency;
+
+            auto lowPass = Coefficients::makeLowPass(sampleRate, frequency, q);
+            auto highPass = Coefficients::makeHighPass(sampleRate, frequency, q);
+            auto allPass = Coefficients::makeAllPass(sampleRate, frequency, q);
+
+            // LR4 is a Butterworth biquad twice; its low and high outputs sum
+            // to a single allpass biquad, which leaves the second section idle.
+            for (size_t band = 0; band < numLanes; ++band) {
+                auto isUsed = k + 1 < numBands && band < numBands;
+                const auto& first = ! isUsed ? identity : band < k ? allPass : band == k ? lowPass : highPass;
+                const auto& second = ! isUsed || band < k ? identity : first;
+
+                sections[2 * k].setLane(band, first);
+                sections[2 * k + 1].setLane(band, second);
+            }
+        }
+    }
+
+    std::array<Section, maxSections> sections;
+    size_t numBands = 2;
+    std::array<float, numCrossovers> frequenciesHz { 200.f, 1000.f, 5000.f };
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0, maximumBlockSize = 0;
+    std::vector<State> state;
+
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> interleaved;
+};
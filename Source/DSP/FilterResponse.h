@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    Magnitude response of the chain's filters on a log-frequency grid.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Evaluates magnitude responses at numPoints log-spaced frequencies from
+    minFrequency to maxFrequency, or Nyquist if lower, and multiplies them
+    together.
+
+    The sines and cosines of the grid are computed once per sample rate, so
+    a filter is one branch-free pass of arithmetic over the grid that the
+    compiler can vectorise.
+*/
+class FilterResponse
+{
+public:
+    static constexpr size_t numPoints = 256;
+    static constexpr float minFrequency = 20.f, maxFrequency = 20000.f;
+
+    void prepare(double newSampleRate) {
+        if (newSampleRate == sampleRate)
+            return;
+
+        sampleRate = newSampleRate;
+        topFrequency = juce::jmin(maxFrequency, static_cast<float>(sampleRate * 0.5));
+
+        for (size_t i = 0; i < numPoints; ++i) {
+            auto frequency = juce::mapToLog10(static_cast<float>(i) / static_cast<float>(numPoints - 1), minFrequency, topFrequency);
+            auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+            cosW[i] = static_cast<float>(std::cos(w));
+            sinW[i] = static_cast<float>(std::sin(w));
+            cos2W[i] = static_cast<float>(std::cos(2.0 * w));
+            sin2W[i] = static_cast<float>(std::sin(2.0 * w));
+        }
+    }
+
+    void reset() { magnitudes.fill(1.f); }
+
+    /** Takes { b0, b1, b2, a0, a1, a2 }, as returned by IIR::ArrayCoefficients. */
+    void applyBiquad(const std::array<float, 6>& c) noexcept {
+        for (size_t i = 0; i < numPoints; ++i) {
+            // With z^-1 = e^-jw: b0 + b1 z^-1 + b2 z^-2 over a0 + a1 z^-1 + a2 z^-2.
+            auto numRe = c[0] + c[1] * cosW[i] + c[2] * cos2W[i];
+            auto numIm = -(c[1] * sinW[i] + c[2] * sin2W[i]);
+            auto denRe = c[3] + c[4] * cosW[i] + c[5] * cos2W[i];
+            auto denIm = -(c[4] * sinW[i] + c[5] * sin2W[i]);
+
+            magnitudes[i] *= std::sqrt((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+        }
+    }
+
+    /** For filters that evaluate their own response, given cos(w) and sin(w) of each point. */
+    template<typename Filter>
+    void apply(const Filter& filter) noexcept {
+        filter.multiplyMagnitudeResponse(cosW.data(), sinW.data(), magnitudes.data(), numPoints);
+    }
+
+    /** Point i lies at i / (numPoints - 1) of the way from minFrequency to this, on a log scale. */
+    float getTopFrequency() const noexcept { return topFrequency; }
+    const std::array<float, numPoints>& getMagnitudes() const noexcept { return magnitudes; }
+
+private:
+    double sampleRate = 0;
+    float topFrequency = maxFrequency;
+
+    std::array<float, numPoints> cosW {}, sinW {}, cos2W {}, sin2W {};
+    std::array<float, numPoints> magnitudes {};
+};
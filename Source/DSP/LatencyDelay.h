@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    Whole-sample delay that keeps a latent module's dry path in time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Delays every channel of a block by a fixed number of samples, through
+    one ring buffer per channel allocated in prepare().
+
+    A module with latency delays whatever it processes; fed the same input
+    every block, this delays its dry signal by as much, so bypassing the
+    module, or not running it at all, leaves the timing of the chain alone.
+*/
+class LatencyDelay
+{
+public:
+    void prepare(size_t numChannels, int maximumDelay) {
+        buffer.setSize(static_cast<int>(numChannels), juce::jmax(1, maximumDelay));
+        delay = juce::jmin(delay, buffer.getNumSamples());
+        reset();
+    }
+
+    void reset() noexcept {
+        buffer.clear();
+        writePosition = 0;
+    }
+
+    /** A new delay starts from silence. */
+    void setDelay(int newDelay) noexcept {
+        newDelay = juce::jlimit(0, buffer.getNumSamples(), newDelay);
+
+        if (newDelay == delay)
+            return;
+
+        delay = newDelay;
+        reset();
+    }
+
+    int getDelay() const noexcept { return delay; }
+
+    /** Writes each channel of input, delayed, to the same channel of output.
+        The two may be the same block; they must have the same size.
+    */
+    void process(const juce::dsp::AudioBlock<const float>& input, const juce::dsp::AudioBlock<float>& output) noexcept {
+        jassert(input.getNumChannels() == output.getNumChannels() && input.getNumSamples() == output.getNumSamples());
+        jassert(input.getNumChannels() <= static_cast<size_t>(buffer.getNumChannels()));
+
+        if (delay == 0) {
+            output.copyFrom(input);
+            return;
+        }
+
+        auto position = writePosition;
+
+        for (size_t ch = 0; ch < input.getNumChannels(); ++ch) {
+            auto* in = input.getChannelPointer(ch);
+            auto* out = output.getChannelPointer(ch);
+            auto* ring = buffer.getWritePointer(static_cast<int>(ch));
+            position = writePosition;
+
+            for (size_t i = 0; i < input.getNumSamples(); ++i) {
+                auto sample = in[i];
+                out[i] = ring[position];
+                ring[position] = sample;
+
+                if (++position == delay)
+                    position = 0;
+            }
+        }
+
+        writePosition = position;
+    }
+
+    size_t getAllocatedBytes() const noexcept {
+        return static_cast<size_t>(buffer.getNumChannels() * buffer.getNumSamples()) * sizeof(float);
+    }
+
+private:
+    juce::AudioBuffer<float> buffer;
+    int delay = 0, writePosition = 0;
+};
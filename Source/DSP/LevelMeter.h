@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    Peak/RMS meter fed on the audio thread and read from any other thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Measures each block's peak and mean square in one SIMD pass, applies
+    meter ballistics, and publishes the result through relaxed atomics.
+
+    The audio thread is the only writer, and readers only load: nothing
+    blocks on either side. Ballistics run on the audio thread, so a reader
+    polling slower than the block rate still sees every peak as it decays.
+*/
+class LevelMeter
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+
+    void reset() {
+        peak = 0.f;
+        meanSquare = 0.f;
+        publishedPeak.store(0.f, std::memory_order_relaxed);
+        publishedRMS.store(0.f, std::memory_order_relaxed);
+    }
+
+    /** Audio thread only. */
+    void process(const juce::dsp::AudioBlock<float>& block, double sampleRate) noexcept {
+        auto numSamples = block.getNumSamples();
+        auto numChannels = block.getNumChannels();
+
+        if (numSamples == 0 || numChannels == 0)
+            return;
+
+        float blockPeak = 0.f, blockSumOfSquares = 0.f;
+
+        for (size_t ch = 0; ch < numChannels; ++ch) {
+            auto [channelPeak, channelSumOfSquares] = measure(block.getChannelPointer(ch), numSamples);
+            blockPeak = juce::jmax(blockPeak, channelPeak);
+            blockSumOfSquares += channelSumOfSquares;
+        }
+
+        update(blockPeak, blockSumOfSquares / static_cast<float>(numSamples * numChannels), numSamples, sampleRate);
+    }
+
+    /** Audio thread only. Falls as if it had measured numSamples of silence,
+        without reading any, for blocks the chain doesn't process.
+    */
+    void decay(size_t numSamples, double sampleRate) noexcept {
+        if (peak == 0.f && meanSquare == 0.f)
+            return;
+
+        update(0.f, 0.f, numSamples, sampleRate);
+
+        // Snap to zero well below the meters' range rather than decaying forever.
+        if (peak < 1.0e-6f) {
+            peak = 0.f;
+            meanSquare = 0.f;
+            publishedPeak.store(0.f, std::memory_order_relaxed);
+            publishedRMS.store(0.f, std::memory_order_relaxed);
+        }
+    }
+
+    /** Any thread. Linear gain. */
+    float getPeak() const noexcept { return publishedPeak.load(std::memory_order_relaxed); }
+    float getRMS() const noexcept { return publishedRMS.load(std::memory_order_relaxed); }
+
+private:
+    void update(float blockPeak, float blockMeanSquare, size_t numSamples, double sampleRate) noexcept {
+        // Instant attack, exponential release for the peak; one-pole average for the RMS.
+        auto blockSeconds = static_cast<double>(numSamples) / sampleRate;
+        auto peakRelease = static_cast<float>(std::exp(-blockSeconds / peakReleaseSeconds));
+        auto rmsSmoothing = static_cast<float>(std::exp(-blockSeconds / rmsWindowSeconds));
+
+        peak = juce::jmax(blockPeak, peak * peakRelease);
+        meanSquare = blockMeanSquare + (meanSquare - blockMeanSquare) * rmsSmoothing;
+
+        publishedPeak.store(peak, std::memory_order_relaxed);
+        publishedRMS.store(std::sqrt(meanSquare), std::memory_order_relaxed);
+    }
+
+    static std::pair<float, float> measure(const float* data, size_t numSamples) noexcept {
+        constexpr auto numLanes = SIMDFloat::SIMDNumElements;
+
+        float peakValue = 0.f, sumOfSquares = 0.f;
+        size_t i = 0;
+
+        // Scalar until the data is aligned, then whole registers, then the remainder.
+        auto* aligned = SIMDFloat::getNextSIMDAlignedPtr(const_cast<float*>(data));
+        auto numHead = juce::jmin(numSamples, static_cast<size_t>(aligned - data));
+
+        for (; i < numHead; ++i) {
+            peakValue = juce::jmax(peakValue, std::abs(data[i]));
+            sumOfSquares += data[i] * data[i];
+        }
+
+        auto zero = SIMDFloat::expand(0.f);
+        auto peaks = zero, squares = zero;
+
+        for (; i + numLanes <= numSamples; i += numLanes) {
+            auto x = SIMDFloat::fromRawArray(data + i);
+            peaks = SIMDFloat::max(peaks, SIMDFloat::max(x, zero - x));
+            squares = squares + x * x;
+        }
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            peakValue = juce::jmax(peakValue, peaks.get(lane));
+
+        sumOfSquares += squares.sum();
+
+        for (; i < numSamples; ++i) {
+            peakValue = juce::jmax(peakValue, std::abs(data[i]));
+            sumOfSquares += data[i] * data[i];
+        }
+
+        return { peakValue, sumOfSquares };
+    }
+
+    static constexpr double peakReleaseSeconds = 0.5;
+    static constexpr double rmsWindowSeconds = 0.3;
+
+    float peak = 0.f, meanSquare = 0.f;
+    std::atomic<float> publishedPeak { 0.f }, publishedRMS { 0.f };
+};
@@ -0,0 +1,227 @@
+/*
+  ==============================================================================
+
+    Control-rate modulation sources: LFOs and an envelope follower.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Low-frequency oscillator evaluated only at control ticks.
+
+    render() produces a whole block's worth of ticks at once. The phase ramp
+    and every shape are branch-free loops over the ticks, which the compiler
+    vectorises.
+*/
+class Lfo
+{
+public:
+    enum class Shape
+    {
+        Sine,       // parabolic approximation, within 0.1% of std::sin
+        Triangle,
+        Saw,
+        Square
+    };
+
+    void reset() { phase = 0.0; }
+
+    void setShape(Shape newShape) { shape = newShape; }
+    void setFrequency(double newFrequencyHz) { frequencyHz = newFrequencyHz; }
+
+    /** Phase in cycles; used to lock a tempo-synced LFO to the host position. */
+    void setPhase(double newPhase) { phase = newPhase - std::floor(newPhase); }
+
+    /** Writes the value in [-1, 1] at each of numTicks ticks, tickInterval samples apart. */
+    void render(float* out, size_t numTicks, size_t tickInterval, double sampleRate) noexcept {
+        auto increment = static_cast<float>(frequencyHz * static_cast<double>(tickInterval) / sampleRate);
+        auto start = static_cast<float>(phase);
+
+        for (size_t i = 0; i < numTicks; ++i) {
+            auto p = start + increment * static_cast<float>(i);
+            out[i] = p - static_cast<float>(static_cast<int>(p));
+        }
+
+        switch (shape) {
+        case Shape::Sine:
+            for (size_t i = 0; i < numTicks; ++i) {
+                // sin(2 pi p) = -sin(pi x) for x = 2p - 1 in [-1, 1)
+                auto x = 2.f * out[i] - 1.f;
+                auto y = 4.f * x * (1.f - std::abs(x));
+                out[i] = -(0.225f * (y * std::abs(y) - y) + y);
+            }
+            break;
+
+        case Shape::Triangle:
+            for (size_t i = 0; i < numTicks; ++i)
+                out[i] = 1.f - 4.f * std::abs(out[i] - 0.5f);
+            break;
+
+        case Shape::Saw:
+            for (size_t i = 0; i < numTicks; ++i)
+                out[i] = 2.f * out[i] - 1.f;
+            break;
+
+        case Shape::Square:
+            for (size_t i = 0; i < numTicks; ++i)
+                out[i] = out[i] < 0.5f ? 1.f : -1.f;
+            break;
+        }
+
+        setPhase(phase + static_cast<double>(increment) * static_cast<double>(numTicks));
+    }
+
+private:
+    Shape shape = Shape::Sine;
+    double frequencyHz = 1.0;
+    double phase = 0.0;
+};
+
+/** Peak envelope of the input, sampled once per control tick, in [0, 1]. */
+class EnvelopeFollower
+{
+public:
+    void reset() { envelope = 0.f; }
+
+    void setAttack(float newAttackMs) { attackMs = newAttackMs; }
+    void setRelease(float newReleaseMs) { releaseMs = newReleaseMs; }
+
+    void render(const juce::dsp::AudioBlock<float>& block, float* out, size_t numTicks, size_t tickInterval, double sampleRate) noexcept {
+        auto tickSeconds = static_cast<double>(tickInterval) / sampleRate;
+        auto attack = static_cast<float>(std::exp(-tickSeconds / (juce::jmax(0.1f, attackMs) * 0.001)));
+        auto release = static_cast<float>(std::exp(-tickSeconds / (juce::jmax(0.1f, releaseMs) * 0.001)));
+        auto numSamples = block.getNumSamples();
+
+        for (size_t tick = 0; tick < numTicks; ++tick) {
+            auto start = tick * tickInterval;
+            auto length = start < numSamples ? juce::jmin(tickInterval, numSamples - start) : 0;
+            float peak = 0.f;
+
+            // findMinAndMax is vectorised over each tick's samples.
+            for (size_t ch = 0; ch < block.getNumChannels() && length > 0; ++ch) {
+                auto range = juce::FloatVectorOperations::findMinAndMax(block.getChannelPointer(ch) + start, static_cast<int>(length));
+                peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+            }
+
+            auto coefficient = peak > envelope ? attack : release;
+            envelope = peak + (envelope - peak) * coefficient;
+            out[tick] = juce::jmin(envelope, 1.f);
+        }
+    }
+
+private:
+    float attackMs = 10.f, releaseMs = 200.f;
+    float envelope = 0.f;
+};
+
+/** Sine LFO for the phaser and chorus, giving every channel of a block its
+    own value: either all linked, or spread evenly around the cycle.
+
+    Only one sin/cos pair is evaluated per tick. Each channel's value is
+    sin(t + p) = sin t cos p + cos t sin p for its fixed offset p, so a
+    whole SIMD group of channels costs two multiplies and an add.
+*/
+class MultiChannelLfo
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    enum class ChannelPhases
+    {
+        Linked,
+        Spread      // channel c starts c / numSpreadChannels of a cycle later
+    };
+
+    void prepare(size_t newNumChannels, size_t maxNumTicks) {
+        numChannels = newNumChannels;
+        auto numGroups = (numChannels + numLanes - 1) / numLanes;
+
+        cosOffsets.resize(numGroups);
+        sinOffsets.resize(numGroups);
+        sinTicks.resize(maxNumTicks);
+        cosTicks.resize(maxNumTicks);
+
+        updateOffsets();
+        reset();
+    }
+
+    // Starts where juce::dsp::Oscillator does, at sin(-pi).
+    void reset() { phase = 0.5; }
+
+    void setFrequency(double newFrequencyHz) { frequencyHz = newFrequencyHz; }
+
+    void setChannelPhases(ChannelPhases newChannelPhases) {
+        if (channelPhases == newChannelPhases)
+            return;
+
+        channelPhases = newChannelPhases;
+        updateOffsets();
+    }
+
+    /** Spread phases repeat every numSpreadChannels channels, so copies of
+        the same channels carried side by side, like the bands of a split
+        signal, share one LFO phase. 0 spreads across all of them.
+    */
+    void setSpreadChannels(size_t newNumSpreadChannels) {
+        if (numSpreadChannels == newNumSpreadChannels)
+            return;
+
+        numSpreadChannels = newNumSpreadChannels;
+        updateOffsets();
+    }
+
+    bool isLinked() const noexcept { return channelPhases == ChannelPhases::Linked; }
+
+    /** Advances by numTicks ticks, tickInterval samples apart, keeping each one's value. */
+    void render(size_t numTicks, size_t tickInterval, double sampleRate) noexcept {
+        jassert(numTicks <= sinTicks.size());
+        auto increment = frequencyHz * static_cast<double>(tickInterval) / sampleRate;
+
+        for (size_t i = 0; i < numTicks; ++i) {
+            auto angle = juce::MathConstants<double>::twoPi * phase;
+            sinTicks[i] = static_cast<float>(std::sin(angle));
+            cosTicks[i] = static_cast<float>(std::cos(angle));
+
+            phase += increment;
+            phase -= std::floor(phase);
+        }
+    }
+
+    size_t getAllocatedBytes() const noexcept {
+        return (cosOffsets.capacity() + sinOffsets.capacity()) * sizeof(SIMDFloat)
+             + (sinTicks.capacity() + cosTicks.capacity()) * sizeof(float);
+    }
+
+    /** The value of channel 0 at a rendered tick: every channel's when linked. */
+    float getLinkedValue(size_t tick) const noexcept { return sinTicks[tick]; }
+
+    /** The values of one group's channels at a rendered tick. */
+    SIMDFloat getGroupValue(size_t group, size_t tick) const noexcept {
+        return cosOffsets[group] * sinTicks[tick] + sinOffsets[group] * cosTicks[tick];
+    }
+
+private:
+    void updateOffsets() {
+        auto period = numSpreadChannels > 0 ? numSpreadChannels : juce::jmax(numChannels, size_t(1));
+
+        for (size_t group = 0; group < cosOffsets.size(); ++group) {
+            for (size_t lane = 0; lane < numLanes; ++lane) {
+                auto channel = (group * numLanes + lane) % period;
+                auto offset = isLinked() ? 0.0 : juce::MathConstants<double>::twoPi * static_cast<double>(channel) / static_cast<double>(period);
+                cosOffsets[group].set(lane, static_cast<float>(std::cos(offset)));
+                sinOffsets[group].set(lane, static_cast<float>(std::sin(offset)));
+            }
+        }
+    }
+
+    ChannelPhases channelPhases = ChannelPhases::Linked;
+    double frequencyHz = 1.0, phase = 0.5;
+    size_t numChannels = 0, numSpreadChannels = 0;
+
+    std::vector<SIMDFloat> cosOffsets, sinOffsets;
+    std::vector<float> sinTicks, cosTicks;
+};
@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+    Lazy preparation and release of modules, off the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Whether a module's buffers exist, handed between the audio thread and a
+    worker with compare-and-swap only.
+
+    The audio thread asks for a module when it is enabled and gives it back
+    once it has been bypassed for a while; the worker does the allocating and
+    freeing in between. The audio thread only touches the module while it is
+    Ready, so the worker never races it. The message thread may set the state
+    directly while the audio thread is stopped, holding the owner's lock.
+*/
+class ModuleLifetime
+{
+public:
+    enum class State
+    {
+        Released,           // no buffers: the module passes audio through
+        PrepareRequested,   // wanted by the audio thread
+        Preparing,          // the worker is allocating
+        Ready,              // owned by the audio thread
+        ReleaseRequested    // given back, the worker frees it
+    };
+
+    State getState() const noexcept { return state.load(std::memory_order_acquire); }
+    bool isReady() const noexcept { return getState() == State::Ready; }
+
+    /** Audio thread. Each returns true if the state changed. */
+    bool requestPrepare() noexcept { return transition(State::Released, State::PrepareRequested); }
+    bool cancelPrepare() noexcept { return transition(State::PrepareRequested, State::Released); }
+    bool requestRelease() noexcept { return transition(State::Ready, State::ReleaseRequested); }
+
+    /** Worker. Runs prepare() and publishes the module if it was requested. */
+    template<typename Prepare>
+    bool servicePrepare(Prepare&& prepare) {
+        if (! transition(State::PrepareRequested, State::Preparing))
+            return false;
+
+        prepare();
+        state.store(State::Ready, std::memory_order_release);
+        return true;
+    }
+
+    /** Worker. Runs release() if the audio thread gave the module back. */
+    template<typename Release>
+    bool serviceRelease(Release&& release) {
+        if (getState() != State::ReleaseRequested)
+            return false;
+
+        release();
+        state.store(State::Released, std::memory_order_release);
+        return true;
+    }
+
+    /** Message thread, while the audio thread is stopped. */
+    void setState(State newState) noexcept { state.store(newState, std::memory_order_release); }
+
+private:
+    bool transition(State from, State to) noexcept {
+        return state.compare_exchange_strong(from, to, std::memory_order_acq_rel);
+    }
+
+    std::atomic<State> state { State::Released };
+};
+
+/** One background thread, shared by every instance in the process through a
+    SharedResourcePointer, that services the modules of all of them.
+
+    The audio thread can't wake a thread without a lock, so the worker polls:
+    every pollIntervalMs it gives each client a chance to prepare and release
+    whatever its audio thread asked for, which is a few atomic loads when
+    nothing was. Clients can also hand it one-off jobs from the message
+    thread, which run before the next poll.
+
+    The worker only holds its lock to pick the next piece of work, never
+    while a client allocates, so adding or removing one instance doesn't
+    wait for the others' preparations, only for its own.
+*/
+class ModuleWorker : private juce::Thread
+{
+public:
+    static constexpr int pollIntervalMs = 10;
+
+    struct Client {
+        virtual ~Client() = default;
+        virtual void serviceModules() = 0;
+    };
+
+    ModuleWorker() : juce::Thread("Module preparation") { startThread(); }
+    ~ModuleWorker() override { stopThread(1000); }
+
+    /** Message thread. Once removed, a client is no longer being serviced. */
+    void addClient(Client& client) {
+        const juce::ScopedLock lock(clientsLock);
+        clients.addIfNotAlreadyThere(&client);
+    }
+
+    /** Also drops the client's jobs that haven't run, and waits for its work in progress. */
+    void removeClient(Client& client) {
+        const juce::ScopedLock lock(clientsLock);
+        clients.removeFirstMatchingValue(&client);
+        jobs.erase(std::remove_if(jobs.begin(), jobs.end(), [&](const Job& job) { return job.client == &client; }), jobs.end());
+
+        while (busyClient == &client) {
+            const juce::ScopedUnlock unlock(clientsLock);
+            clientIdle.wait(pollIntervalMs);
+        }
+    }
+
+    /** Message thread. Runs the job once on the worker, for a client that has been added. */
+    void addJob(Client& client, std::function<void()> function) {
+        {
+            const juce::ScopedLock lock(clientsLock);
+            jassert(clients.contains(&client));
+            jobs.push_back({ &client, std::move(function) });
+        }
+
+        notify();
+    }
+
+private:
+    struct Job {
+        Client* client = nullptr;
+        std::function<void()> function;
+    };
+
+    void run() override {
+        juce::Array<Client*> clientsToService;
+
+        while (! threadShouldExit()) {
+            // Jobs are taken one at a time, so removeClient can still drop the rest.
+            for (;;) {
+                Job job;
+
+                {
+                    const juce::ScopedLock lock(clientsLock);
+
+                    if (jobs.empty())
+                        break;
+
+                    job = std::move(jobs.front());
+                    jobs.erase(jobs.begin());
+                    busyClient = job.client;
+                }
+
+                job.function();
+                setIdle();
+            }
+
+            {
+                const juce::ScopedLock lock(clientsLock);
+                clientsToService = clients;
+            }
+
+            for (auto* client : clientsToService) {
+                {
+                    const juce::ScopedLock lock(clientsLock);
+
+                    // Removed since the copy: it may be gone already.
+                    if (! clients.contains(client))
+                        continue;
+
+                    busyClient = client;
+                }
+
+                client->serviceModules();
+                setIdle();
+            }
+
+            wait(pollIntervalMs);
+        }
+    }
+
+    void setIdle() {
+        {
+            const juce::ScopedLock lock(clientsLock);
+            busyClient = nullptr;
+        }
+
+        clientIdle.signal();
+    }
+
+    juce::CriticalSection clientsLock;
+    juce::Array<Client*> clients;
+    std::vector<Job> jobs;
+    Client* busyClient = nullptr;       // whose job or service is running, off the lock
+    juce::WaitableEvent clientIdle;
+};
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    Biquad filter that keeps each channel's state in its own SIMD lane.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelLanes.h"
+
+/** Transposed direct form II biquad for any number of channels.
+
+    Channels are interleaved into groups of SIMDRegister<float>::size(), so a
+    stereo or wider block is filtered in a single vectorised pass with every
+    channel keeping its own state. Coefficients are shared by all groups, but
+    each lane can be given its own set.
+*/
+class MultiChannelBiquad
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    MultiChannelBiquad() {
+        setCoefficients({ 1.f, 0.f, 0.f, 1.f, 0.f, 0.f });
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        numChannels = spec.numChannels;
+        numGroups = (numChannels + numLanes - 1) / numLanes;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, numGroups, maximumBlockSize);
+        state.resize(numGroups);
+        reset();
+    }
+
+    void reset() {
+        for (auto& s : state)
+            s = {};
+    }
+
+    /** Takes { b0, b1, b2, a0, a1, a2 }, as returned by IIR::ArrayCoefficients. */
+    void setCoefficients(const std::array<float, 6>& c) {
+        auto a0Inv = 1.f / c[3];
+        b0 = SIMDFloat::expand(c[0] * a0Inv);
+        b1 = SIMDFloat::expand(c[1] * a0Inv);
+        b2 = SIMDFloat::expand(c[2] * a0Inv);
+        a1 = SIMDFloat::expand(c[4] * a0Inv);
+        a2 = SIMDFloat::expand(c[5] * a0Inv);
+    }
+
+    /** Sets the coefficients of one lane only, in every channel group. */
+    void setLaneCoefficients(size_t lane, const std::array<float, 6>& c) {
+        jassert(lane < numLanes);
+        auto a0Inv = 1.f / c[3];
+        b0.set(lane, c[0] * a0Inv);
+        b1.set(lane, c[1] * a0Inv);
+        b2.set(lane, c[2] * a0Inv);
+        a1.set(lane, c[4] * a0Inv);
+        a2.set(lane, c[5] * a0Inv);
+    }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return interleaved.getNumChannels() * interleaved.getNumSamples() * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State);
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        auto numSamples = outputBlock.getNumSamples();
+        auto numBlockChannels = outputBlock.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        for (size_t group = 0; group * numLanes < numBlockChannels; ++group) {
+            ChannelLanes::interleave(inputBlock, group, interleaved.getChannelPointer(group));
+
+            processGroup(interleaved.getChannelPointer(group), numSamples, state[group]);
+
+            ChannelLanes::deinterleave(interleaved.getChannelPointer(group), group, outputBlock);
+        }
+    }
+
+private:
+    struct State {
+        SIMDFloat z1 = SIMDFloat::expand(0.f), z2 = SIMDFloat::expand(0.f);
+    };
+
+    void processGroup(SIMDFloat* samples, size_t numSamples, State& s) noexcept {
+        auto z1 = s.z1, z2 = s.z2;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            auto x = samples[i];
+            auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            samples[i] = y;
+        }
+
+        s.z1 = z1;
+        s.z2 = z2;
+    }
+
+    SIMDFloat b0, b1, b2, a1, a2;
+
+    size_t numChannels = 0, numGroups = 0, maximumBlockSize = 0;
+    std::vector<State> state;
+
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> interleaved;
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    Chorus that processes its channels in SIMD groups.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelLanes.h"
+#include "ModulationSources.h"
+
+/** The algorithm of juce::dsp::Chorus: a linearly interpolated delay line
+    with feedback, its delay time swept by a sine LFO.
+
+    Like TempoDelay, the channels are interleaved into groups of
+    SIMDRegister<float>::size() sharing one ring buffer. With the LFO linked
+    every lane reads at the same delay, so reads are whole registers; spread
+    across channels, each lane reads at its own delay.
+*/
+class MultiChannelChorus
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    using ChannelPhases = MultiChannelLfo::ChannelPhases;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    static constexpr float maxCentreDelayMs = 100.f;
+    static constexpr float maxModulationMs = 10.f;      // full depth sweeps the delay this far each way
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        numGroups = (numChannels + numLanes - 1) / numLanes;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        auto maxDelaySamples = static_cast<int>(std::ceil((maxCentreDelayMs + maxModulationMs) * sampleRate / 1000.0));
+        auto ringSize = static_cast<size_t>(juce::nextPowerOfTwo(maxDelaySamples + 2));
+        ringMask = ringSize - 1;
+
+        ring = juce::dsp::AudioBlock<SIMDFloat>(ringData, numGroups, ringSize);
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, numGroups, maximumBlockSize);
+        state.resize(numGroups);
+
+        lfo.prepare(numChannels, maximumBlockSize);
+        depthPerSample.resize(maximumBlockSize);
+        linkedDelays.resize(maximumBlockSize);
+        feedbackPerSample.resize(maximumBlockSize);
+        mixPerSample.resize(maximumBlockSize);
+
+        reset();
+    }
+
+    void reset() {
+        for (size_t group = 0; group < numGroups; ++group)
+            std::fill_n(ring.getChannelPointer(group), ringMask + 1, SIMDFloat::expand(0.f));
+
+        for (auto& s : state)
+            s = {};
+
+        lfo.reset();
+        writePos = 0;
+
+        depthSmoother.reset(sampleRate, 0.05);
+        depthSmoother.setCurrentAndTargetValue(depth);
+        feedbackSmoother.reset(sampleRate, 0.05);
+        feedbackSmoother.setCurrentAndTargetValue(feedback);
+        mixSmoother.reset(sampleRate, 0.05);
+        mixSmoother.setCurrentAndTargetValue(mix);
+    }
+
+    void setRate(float newRateHz) { lfo.setFrequency(newRateHz); }
+
+    void setDepth(float newDepth) {
+        depth = juce::jlimit(0.f, 1.f, newDepth);
+        depthSmoother.setTargetValue(depth);
+    }
+
+    void setCentreDelay(float newCentreDelayMs) { centreDelayMs = juce::jlimit(1.f, maxCentreDelayMs, newCentreDelayMs); }
+
+    void setFeedback(float newFeedback) {
+        feedback = juce::jlimit(-1.f, 1.f, newFeedback);
+        feedbackSmoother.setTargetValue(feedback);
+    }
+
+    void setMix(float newMix) {
+        mix = juce::jlimit(0.f, 1.f, newMix);
+        mixSmoother.setTargetValue(mix);
+    }
+
+    void setChannelPhases(ChannelPhases newChannelPhases) { lfo.setChannelPhases(newChannelPhases); }
+    void setSpreadChannels(size_t numSpreadChannels) { lfo.setSpreadChannels(numSpreadChannels); }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return (ring.getNumChannels() * ring.getNumSamples() + interleaved.getNumChannels() * interleaved.getNumSamples()) * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State)
+             + (depthPerSample.capacity() + linkedDelays.capacity() + feedbackPerSample.capacity() + mixPerSample.capacity()) * sizeof(float)
+             + lfo.getAllocatedBytes();
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        auto numSamples = outputBlock.getNumSamples();
+        auto numBlockChannels = outputBlock.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        // The LFO and the smoothed values are shared by every channel group, so step them once.
+        lfo.render(numSamples, 1, sampleRate);
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            depthPerSample[i] = depthSmoother.getNextValue();
+            feedbackPerSample[i] = feedbackSmoother.getNextValue();
+            mixPerSample[i] = mixSmoother.getNextValue();
+
+            if (lfo.isLinked())
+                linkedDelays[i] = getDelayInSamples(lfo.getLinkedValue(i) * depthPerSample[i]);
+        }
+
+        for (size_t group = 0; group * numLanes < numBlockChannels; ++group) {
+            ChannelLanes::interleave(inputBlock, group, interleaved.getChannelPointer(group));
+
+            if (lfo.isLinked())
+                processGroup<true>(interleaved.getChannelPointer(group), numSamples, group, state[group]);
+            else
+                processGroup<false>(interleaved.getChannelPointer(group), numSamples, group, state[group]);
+
+            ChannelLanes::deinterleave(interleaved.getChannelPointer(group), group, outputBlock);
+        }
+
+        writePos = (writePos + numSamples) & ringMask;
+    }
+
+private:
+    struct State {
+        SIMDFloat lastOutput = SIMDFloat::expand(0.f);
+    };
+
+    /** Delay for an LFO value in [-1, 1] already scaled by the depth. */
+    float getDelayInSamples(float lfoValue) const noexcept {
+        auto delayMs = juce::jmax(1.f, centreDelayMs + maxModulationMs * lfoValue);
+        return delayMs * static_cast<float>(sampleRate / 1000.0);
+    }
+
+    template<bool Linked>
+    void processGroup(SIMDFloat* samples, size_t numSamples, size_t group, State& s) noexcept {
+        auto* delayed = ring.getChannelPointer(group);
+        auto* delayedLanes = reinterpret_cast<const float*>(delayed);
+        auto lastOutput = s.lastOutput;
+        auto w = writePos;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            auto dry = samples[i];
+
+            // Written before the read, so the delay counts from the current sample.
+            delayed[w] = dry - lastOutput;
+            SIMDFloat wet;
+
+            if constexpr (Linked) {
+                auto delay = linkedDelays[i];
+                auto delayInt = static_cast<size_t>(delay);
+                auto frac = delay - static_cast<float>(delayInt);
+
+                auto s0 = delayed[(w - delayInt) & ringMask];
+                auto s1 = delayed[(w - delayInt - 1) & ringMask];
+                wet = s0 + (s1 - s0) * frac;
+            } else {
+                auto values = lfo.getGroupValue(group, i) * depthPerSample[i];
+
+                for (size_t lane = 0; lane < numLanes; ++lane) {
+                    auto delay = getDelayInSamples(values.get(lane));
+                    auto delayInt = static_cast<size_t>(delay);
+                    auto frac = delay - static_cast<float>(delayInt);
+
+                    auto s0 = delayedLanes[((w - delayInt) & ringMask) * numLanes + lane];
+                    auto s1 = delayedLanes[((w - delayInt - 1) & ringMask) * numLanes + lane];
+                    wet.set(lane, s0 + (s1 - s0) * frac);
+                }
+            }
+
+            lastOutput = wet * feedbackPerSample[i];
+            samples[i] = dry + (wet - dry) * mixPerSample[i];
+
+            w = (w + 1) & ringMask;
+        }
+
+        s.lastOutput = lastOutput;
+    }
+
+    MultiChannelLfo lfo;
+    float depth = 0.f, centreDelayMs = 7.f, feedback = 0.f, mix = 0.f;
+
+    juce::SmoothedValue<float> depthSmoother, feedbackSmoother, mixSmoother;
+    std::vector<float> depthPerSample, linkedDelays, feedbackPerSample, mixPerSample;
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0, numGroups = 0, maximumBlockSize = 0;
+    size_t ringMask = 0, writePos = 0;
+    std::vector<State> state;
+
+    juce::HeapBlock<char> ringData, interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> ring, interleaved;
+};
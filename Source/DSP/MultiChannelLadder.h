@@ -0,0 +1,235 @@
+/*
+  ==============================================================================
+
+    Ladder filter that processes its channels in SIMD groups.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelLanes.h"
+
+/** The algorithm of juce::dsp::LadderFilter: four one-pole stages with
+    saturating resonance feedback, and the modes mixing the stage outputs.
+
+    Like MultiChannelBiquad, the channels are interleaved into groups of
+    SIMDRegister<float>::size(). The saturation is Overdrive's rational tanh
+    rather than JUCE's 128-point lookup table, which doesn't vectorise.
+*/
+class MultiChannelLadder
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    using Mode = juce::dsp::LadderFilterMode;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    MultiChannelLadder() {
+        setMode(Mode::LPF12);
+        setResonance(0.f);
+        setDrive(1.2f);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        numGroups = (numChannels + numLanes - 1) / numLanes;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, numGroups, maximumBlockSize);
+        state.resize(numGroups);
+
+        cutoffPerSample.resize(maximumBlockSize);
+        resonancePerSample.resize(maximumBlockSize);
+
+        cutoffSmoother.reset(sampleRate, 0.05);
+        resonanceSmoother.reset(sampleRate, 0.05);
+        setCutoffFrequencyHz(cutoffHz);
+        reset();
+    }
+
+    void reset() {
+        for (auto& s : state)
+            s = {};
+
+        cutoffSmoother.setCurrentAndTargetValue(cutoffSmoother.getTargetValue());
+        resonanceSmoother.setCurrentAndTargetValue(resonanceSmoother.getTargetValue());
+    }
+
+    void setMode(Mode newMode) {
+        if (mode == newMode)
+            return;
+
+        switch (newMode) {
+        case Mode::LPF12: mix = { 0.f, 0.f, 1.f, 0.f, 0.f };   compensation = 0.5f; break;
+        case Mode::HPF12: mix = { 1.f, -2.f, 1.f, 0.f, 0.f };  compensation = 0.f;  break;
+        case Mode::BPF12: mix = { 0.f, 0.f, -1.f, 1.f, 0.f };  compensation = 0.5f; break;
+        case Mode::LPF24: mix = { 0.f, 0.f, 0.f, 0.f, 1.f };   compensation = 0.5f; break;
+        case Mode::HPF24: mix = { 1.f, -4.f, 6.f, -4.f, 1.f }; compensation = 0.f;  break;
+        case Mode::BPF24: mix = { 0.f, 0.f, 1.f, -2.f, 1.f };  compensation = 0.5f; break;
+        }
+
+        for (auto& m : mix)
+            m *= 1.2f;
+
+        mode = newMode;
+        reset();
+    }
+
+    void setCutoffFrequencyHz(float newCutoffHz) {
+        cutoffHz = newCutoffHz;
+        cutoffSmoother.setTargetValue(std::exp(cutoffHz * static_cast<float>(-juce::MathConstants<double>::twoPi / sampleRate)));
+    }
+
+    void setResonance(float newResonance) {
+        resonanceSmoother.setTargetValue(juce::jmap(juce::jlimit(0.f, 1.f, newResonance), 0.1f, 1.f));
+    }
+
+    void setDrive(float newDrive) {
+        drive = juce::jmax(1.f, newDrive);
+        gain = std::pow(drive, -2.642f) * 0.6103f + 0.3903f;
+        drive2 = drive * 0.04f + 0.96f;
+        gain2 = std::pow(drive2, -2.642f) * 0.6103f + 0.3903f;
+    }
+
+    /** Multiplies magnitudes by the small-signal response at the target
+        cutoff and resonance, taking the saturation as linear. cosW and sinW
+        hold cos(w) and sin(w) of each point's normalised angular frequency.
+    */
+    void multiplyMagnitudeResponse(const float* cosW, const float* sinW, float* magnitudes, size_t numPoints) const noexcept {
+        auto a1 = cutoffSmoother.getTargetValue();
+        auto g = 1.f - a1;
+        auto b0 = g * 0.76923076923f;
+        auto b1 = g * 0.23076923076f;
+        auto resonance = resonanceSmoother.getTargetValue();
+
+        // a = in * drive * gain * (1 + 4 r compensation) - 4 r * drive2 * gain2 * e[n - 1]
+        auto inputGain = drive * gain * (1.f + 4.f * resonance * compensation);
+        auto feedback = 4.f * resonance * drive2 * gain2;
+
+        for (size_t i = 0; i < numPoints; ++i) {
+            // z^-1 = e^-jw; each stage is (b0 + b1 z^-1) / (1 - a1 z^-1).
+            auto zRe = cosW[i], zIm = -sinW[i];
+            auto numRe = b0 + b1 * zRe, numIm = b1 * zIm;
+            auto denRe = 1.f - a1 * zRe, denIm = -a1 * zIm;
+            auto den = denRe * denRe + denIm * denIm;
+            auto stageRe = (numRe * denRe + numIm * denIm) / den;
+            auto stageIm = (numIm * denRe - numRe * denIm) / den;
+
+            // The mode's mix of the stage outputs, and the fourth stage alongside.
+            auto powRe = 1.f, powIm = 0.f;
+            auto sumRe = mix[0], sumIm = 0.f;
+
+            for (size_t k = 1; k < mix.size(); ++k) {
+                auto re = powRe * stageRe - powIm * stageIm;
+                powIm = powRe * stageIm + powIm * stageRe;
+                powRe = re;
+                sumRe += mix[k] * powRe;
+                sumIm += mix[k] * powIm;
+            }
+
+            // Resonance loop: 1 + feedback * z^-1 * stage^4.
+            auto loopRe = 1.f + feedback * (zRe * powRe - zIm * powIm);
+            auto loopIm = feedback * (zRe * powIm + zIm * powRe);
+
+            magnitudes[i] *= inputGain * std::sqrt((sumRe * sumRe + sumIm * sumIm) / (loopRe * loopRe + loopIm * loopIm));
+        }
+    }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return interleaved.getNumChannels() * interleaved.getNumSamples() * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State)
+             + (cutoffPerSample.capacity() + resonancePerSample.capacity()) * sizeof(float);
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        auto numSamples = outputBlock.getNumSamples();
+        auto numBlockChannels = outputBlock.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        // The smoothed values are shared by every channel group, so step them once.
+        for (size_t i = 0; i < numSamples; ++i) {
+            cutoffPerSample[i] = cutoffSmoother.getNextValue();
+            resonancePerSample[i] = resonanceSmoother.getNextValue();
+        }
+
+        for (size_t group = 0; group * numLanes < numBlockChannels; ++group) {
+            ChannelLanes::interleave(inputBlock, group, interleaved.getChannelPointer(group));
+
+            processGroup(interleaved.getChannelPointer(group), numSamples, state[group]);
+
+            ChannelLanes::deinterleave(interleaved.getChannelPointer(group), group, outputBlock);
+        }
+    }
+
+private:
+    struct State {
+        std::array<SIMDFloat, 5> s {};
+    };
+
+    static SIMDFloat saturate(SIMDFloat x) noexcept {
+        x = SIMDFloat::min(SIMDFloat::max(x, SIMDFloat::expand(-5.f)), SIMDFloat::expand(5.f));
+        auto x2 = x * x;
+        auto numerator = x * (x2 * (x2 * (x2 + 378.f) + 17325.f) + 135135.f);
+        auto denominator = x2 * (x2 * (x2 * 28.f + 3150.f) + 62370.f) + 135135.f;
+
+        SIMDFloat result;
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            result.set(lane, numerator.get(lane) / denominator.get(lane));
+
+        return result;
+    }
+
+    void processGroup(SIMDFloat* samples, size_t numSamples, State& st) noexcept {
+        auto s = st.s;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            auto a1 = cutoffPerSample[i];
+            auto g = 1.f - a1;
+            auto b0 = g * 0.76923076923f;
+            auto b1 = g * 0.23076923076f;
+
+            auto dx = saturate(samples[i] * drive) * gain;
+            auto a = dx + (saturate(s[4] * drive2) * gain2 - dx * compensation) * (resonancePerSample[i] * -4.f);
+            auto b = s[0] * b1 + s[1] * a1 + a * b0;
+            auto c = s[1] * b1 + s[2] * a1 + b * b0;
+            auto d = s[2] * b1 + s[3] * a1 + c * b0;
+            auto e = s[3] * b1 + s[4] * a1 + d * b0;
+
+            s = { a, b, c, d, e };
+            samples[i] = a * mix[0] + b * mix[1] + c * mix[2] + d * mix[3] + e * mix[4];
+        }
+
+        st.s = s;
+    }
+
+    Mode mode = Mode::LPF24;
+    std::array<float, 5> mix {};
+    float compensation = 0.5f;
+    float cutoffHz = 200.f, drive = 1.f, gain = 1.f, drive2 = 1.f, gain2 = 1.f;
+
+    juce::SmoothedValue<float> cutoffSmoother, resonanceSmoother;
+    std::vector<float> cutoffPerSample, resonancePerSample;
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0, numGroups = 0, maximumBlockSize = 0;
+    std::vector<State> state;
+
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> interleaved;
+};
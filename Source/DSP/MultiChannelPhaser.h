@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    Phaser that processes its channels in SIMD groups.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelLanes.h"
+#include "ModulationSources.h"
+
+/** The algorithm of juce::dsp::Phaser: six first-order TPT allpass stages
+    with feedback, their cutoff swept by a sine LFO and updated every
+    updateInterval samples.
+
+    Like MultiChannelBiquad, the channels are interleaved into groups of
+    SIMDRegister<float>::size(), so the allpass chain runs once per group.
+    The LFO can be linked across channels or spread around the cycle; the
+    per-channel cutoffs are only computed when it is spread.
+*/
+class MultiChannelPhaser
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    using ChannelPhases = MultiChannelLfo::ChannelPhases;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+    static constexpr size_t numStages = 6;
+    static constexpr size_t updateInterval = 4;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        numGroups = (numChannels + numLanes - 1) / numLanes;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, numGroups, maximumBlockSize);
+        state.resize(numGroups);
+
+        auto maxNumTicks = maximumBlockSize / updateInterval + 1;
+        lfo.prepare(numChannels, maxNumTicks);
+        depthPerTick.resize(maxNumTicks);
+        linkedCutoffs.resize(maxNumTicks);
+        feedbackPerSample.resize(maximumBlockSize);
+        mixPerSample.resize(maximumBlockSize);
+
+        maxFrequency = static_cast<float>(juce::jmin(20000.0, 0.49 * sampleRate));
+        setCentreFrequency(centreFrequency);
+        reset();
+    }
+
+    void reset() {
+        for (auto& s : state)
+            s = {};
+
+        lfo.reset();
+        updateCounter = 0;
+
+        depthSmoother.reset(sampleRate / static_cast<double>(updateInterval), 0.05);
+        depthSmoother.setCurrentAndTargetValue(depth * 0.5f);
+        feedbackSmoother.reset(sampleRate, 0.05);
+        feedbackSmoother.setCurrentAndTargetValue(feedback);
+        mixSmoother.reset(sampleRate, 0.05);
+        mixSmoother.setCurrentAndTargetValue(mix);
+    }
+
+    void setRate(float newRateHz) { lfo.setFrequency(newRateHz); }
+
+    void setDepth(float newDepth) {
+        depth = juce::jlimit(0.f, 1.f, newDepth);
+        depthSmoother.setTargetValue(depth * 0.5f);
+    }
+
+    void setCentreFrequency(float newCentreHz) {
+        centreFrequency = newCentreHz;
+        normCentreFrequency = juce::mapFromLog10(juce::jlimit(20.f, maxFrequency, centreFrequency), 20.f, maxFrequency);
+    }
+
+    void setFeedback(float newFeedback) {
+        feedback = juce::jlimit(-1.f, 1.f, newFeedback);
+        feedbackSmoother.setTargetValue(feedback);
+    }
+
+    void setMix(float newMix) {
+        mix = juce::jlimit(0.f, 1.f, newMix);
+        mixSmoother.setTargetValue(mix);
+    }
+
+    void setChannelPhases(ChannelPhases newChannelPhases) { lfo.setChannelPhases(newChannelPhases); }
+    void setSpreadChannels(size_t numSpreadChannels) { lfo.setSpreadChannels(numSpreadChannels); }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return interleaved.getNumChannels() * interleaved.getNumSamples() * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State)
+             + (depthPerTick.capacity() + linkedCutoffs.capacity() + feedbackPerSample.capacity() + mixPerSample.capacity()) * sizeof(float)
+             + lfo.getAllocatedBytes();
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        auto numSamples = outputBlock.getNumSamples();
+        auto numBlockChannels = outputBlock.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        // The LFO and the smoothed values are shared by every channel group, so step them once.
+        auto numTicks = (updateCounter + numSamples + updateInterval - 1) / updateInterval - (updateCounter > 0 ? 1 : 0);
+        lfo.render(numTicks, updateInterval, sampleRate);
+
+        for (size_t tick = 0; tick < numTicks; ++tick) {
+            depthPerTick[tick] = depthSmoother.getNextValue();
+
+            if (lfo.isLinked())
+                linkedCutoffs[tick] = getCutoffCoefficient(lfo.getLinkedValue(tick) * depthPerTick[tick]);
+        }
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            feedbackPerSample[i] = feedbackSmoother.getNextValue();
+            mixPerSample[i] = mixSmoother.getNextValue();
+        }
+
+        for (size_t group = 0; group * numLanes < numBlockChannels; ++group) {
+            ChannelLanes::interleave(inputBlock, group, interleaved.getChannelPointer(group));
+
+            processGroup(interleaved.getChannelPointer(group), numSamples, group, state[group]);
+
+            ChannelLanes::deinterleave(interleaved.getChannelPointer(group), group, outputBlock);
+        }
+
+        updateCounter = (updateCounter + numSamples) % updateInterval;
+    }
+
+private:
+    struct State {
+        std::array<SIMDFloat, numStages> stages {};
+        SIMDFloat lastOutput = SIMDFloat::expand(0.f);
+        SIMDFloat cutoff = SIMDFloat::expand(0.f);
+    };
+
+    /** The TPT one-pole coefficient G = g / (1 + g) for an LFO value in [-0.5, 0.5]. */
+    float getCutoffCoefficient(float lfoValue) const noexcept {
+        auto position = juce::jlimit(0.f, 1.f, lfoValue + normCentreFrequency);
+        auto frequency = juce::mapToLog10(position, 20.f, maxFrequency);
+        auto g = std::tan(juce::MathConstants<float>::pi * frequency / static_cast<float>(sampleRate));
+        return g / (1.f + g);
+    }
+
+    SIMDFloat getGroupCutoff(size_t group, size_t tick) const noexcept {
+        if (lfo.isLinked())
+            return SIMDFloat::expand(linkedCutoffs[tick]);
+
+        auto values = lfo.getGroupValue(group, tick) * depthPerTick[tick];
+        SIMDFloat cutoffs;
+
+        for (size_t lane = 0; lane < numLanes; ++lane)
+            cutoffs.set(lane, getCutoffCoefficient(values.get(lane)));
+
+        return cutoffs;
+    }
+
+    void processGroup(SIMDFloat* samples, size_t numSamples, size_t group, State& s) noexcept {
+        auto stages = s.stages;
+        auto lastOutput = s.lastOutput;
+        auto cutoff = s.cutoff;
+        auto counter = updateCounter;
+        size_t tick = 0;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            if (counter == 0)
+                cutoff = getGroupCutoff(group, tick++);
+
+            auto dry = samples[i];
+            auto wet = dry - lastOutput;
+
+            for (auto& stage : stages) {
+                auto v = (wet - stage) * cutoff;
+                auto lowpass = v + stage;
+                stage = lowpass + v;
+                wet = lowpass + lowpass - wet;
+            }
+
+            lastOutput = wet * feedbackPerSample[i];
+            samples[i] = dry + (wet - dry) * mixPerSample[i];
+
+            if (++counter == updateInterval)
+                counter = 0;
+        }
+
+        s.stages = stages;
+        s.lastOutput = lastOutput;
+        s.cutoff = cutoff;
+    }
+
+    MultiChannelLfo lfo;
+    float depth = 0.f, feedback = 0.f, mix = 0.f;
+    float centreFrequency = 1000.f, normCentreFrequency = 0.5f, maxFrequency = 20000.f;
+
+    juce::SmoothedValue<float> depthSmoother, feedbackSmoother, mixSmoother;
+    std::vector<float> depthPerTick, linkedCutoffs, feedbackPerSample, mixPerSample;
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0, numGroups = 0, maximumBlockSize = 0, updateCounter = 0;
+    std::vector<State> state;
+
+    juce::HeapBlock<char> interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> interleaved;
+};
@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+
+    Waveshaping overdrive with selectable kernel and oversampling factor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Drives the signal into a static waveshaper, optionally oversampled 2x, 4x
+    or 8x with polyphase half-band IIR filters to keep aliasing down.
+
+    All oversamplers are built in prepare(), so switching the factor while
+    playing doesn't allocate. The kernels are plain branch-free loops over
+    each channel, which the compiler vectorises.
+*/
+class Overdrive
+{
+public:
+    enum class Kernel
+    {
+        Tanh,           // std::tanh, the reference
+        RationalTanh,   // Pade approximant, accurate to about 1e-4 on [-5, 5]
+        SoftClip,       // cubic polynomial, hard limit beyond +-1
+        Table           // linear interpolation in a 1024-point tanh table
+    };
+
+    static constexpr size_t maxOversamplingOrder = 3;
+
+    Overdrive() {
+        tanhTable.initialise([](float x) { return std::tanh(x); }, -tableRange, tableRange, 1024);
+
+        // Builds the latency table here, on the thread constructing the modules.
+        getOversamplingLatency(0);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        numChannels = spec.numChannels;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        for (size_t i = 0; i < oversamplers.size(); ++i) {
+            oversamplers[i] = std::make_unique<juce::dsp::Oversampling<float>>(spec.numChannels,
+                                                                               i + 1,
+                                                                               juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR,
+                                                                               true,
+                                                                               true);
+            oversamplers[i]->initProcessing(spec.maximumBlockSize);
+        }
+
+        inputGain.prepare(spec);
+        inputGain.setRampDurationSeconds(0.02);
+        reset();
+    }
+
+    void reset() {
+        inputGain.reset();
+
+        for (auto& oversampler : oversamplers)
+            if (oversampler != nullptr)
+                oversampler->reset();
+    }
+
+    void setDrive(float newDrive) { inputGain.setGainLinear(newDrive); }
+    void setKernel(Kernel newKernel) { kernel = newKernel; }
+
+    /** 0 = no oversampling, 1 = 2x, 2 = 4x, 3 = 8x. The newly selected
+        oversampler starts clean rather than with what it held when last used.
+    */
+    void setOversamplingOrder(size_t newOrder) {
+        jassert(newOrder <= maxOversamplingOrder);
+        newOrder = juce::jmin(newOrder, maxOversamplingOrder);
+
+        if (newOrder == oversamplingOrder)
+            return;
+
+        oversamplingOrder = newOrder;
+
+        if (oversamplingOrder > 0 && oversamplers[oversamplingOrder - 1] != nullptr)
+            oversamplers[oversamplingOrder - 1]->reset();
+    }
+
+    int getLatencyInSamples() const { return getOversamplingLatency(oversamplingOrder); }
+
+    /** The latency of an oversampling order, whether or not a module is
+        prepared: it only depends on the filters' design.
+    */
+    static int getOversamplingLatency(size_t order) {
+        static const auto latencies = [] {
+            std::array<int, maxOversamplingOrder + 1> samples {};
+
+            for (size_t i = 1; i <= maxOversamplingOrder; ++i) {
+                juce::dsp::Oversampling<float> oversampler(1, i, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, true);
+                oversampler.initProcessing(1);
+                samples[i] = juce::roundToInt(oversampler.getLatencyInSamples());
+            }
+
+            return samples;
+        }();
+
+        return latencies[juce::jmin(order, maxOversamplingOrder)];
+    }
+
+    static int getMaximumLatency() {
+        int latency = 0;
+
+        for (size_t order = 0; order <= maxOversamplingOrder; ++order)
+            latency = juce::jmax(latency, getOversamplingLatency(order));
+
+        return latency;
+    }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes: the oversamplers'
+        stage buffers, each twice the length of the one before.
+    */
+    size_t getAllocatedBytes() const noexcept {
+        size_t bytes = 0;
+
+        for (size_t i = 0; i < oversamplers.size(); ++i)
+            if (oversamplers[i] != nullptr)
+                for (size_t stage = 1; stage <= i + 1; ++stage)
+                    bytes += numChannels * (maximumBlockSize << stage) * sizeof(float);
+
+        return bytes;
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        static_assert(std::is_same_v<typename ProcessContext::SampleType, float>);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                context.getOutputBlock().copyFrom(context.getInputBlock());
+
+            return;
+        }
+
+        auto& block = context.getOutputBlock();
+
+        if (context.usesSeparateInputAndOutputBlocks())
+            block.copyFrom(context.getInputBlock());
+
+        inputGain.process(juce::dsp::ProcessContextReplacing<float>(block));
+
+        if (oversamplingOrder == 0) {
+            shape(block);
+            return;
+        }
+
+        auto& oversampler = *oversamplers[oversamplingOrder - 1];
+        auto oversampledBlock = oversampler.processSamplesUp(block);
+        shape(oversampledBlock);
+        oversampler.processSamplesDown(block);
+    }
+
+    /** Applies the current kernel in place. */
+    void shape(float* data, size_t numSamples) const noexcept {
+        switch (kernel) {
+        case Kernel::Tanh:
+            for (size_t i = 0; i < numSamples; ++i)
+                data[i] = std::tanh(data[i]);
+            break;
+
+        case Kernel::RationalTanh:
+            for (size_t i = 0; i < numSamples; ++i) {
+                auto x = juce::jlimit(-rationalRange, rationalRange, data[i]);
+                auto x2 = x * x;
+                auto numerator = x * (135135.f + x2 * (17325.f + x2 * (378.f + x2)));
+                auto denominator = 135135.f + x2 * (62370.f + x2 * (3150.f + 28.f * x2));
+                data[i] = numerator / denominator;
+            }
+            break;
+
+        case Kernel::SoftClip:
+            for (size_t i = 0; i < numSamples; ++i) {
+                auto x = juce::jlimit(-1.f, 1.f, data[i]);
+                data[i] = 1.5f * x - 0.5f * x * x * x;
+            }
+            break;
+
+        case Kernel::Table:
+            tanhTable.process(data, data, numSamples);
+            break;
+        }
+    }
+
+private:
+    void shape(const juce::dsp::AudioBlock<float>& block) noexcept {
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            shape(block.getChannelPointer(ch), block.getNumSamples());
+    }
+
+    static constexpr float tableRange = 5.f;
+    static constexpr float rationalRange = 5.f;     // FastMathApproximations::tanh's valid range
+
+    Kernel kernel = Kernel::RationalTanh;
+    size_t oversamplingOrder = 0;
+    size_t numChannels = 0, maximumBlockSize = 0;
+
+    juce::dsp::Gain<float> inputGain;
+    std::array<std::unique_ptr<juce::dsp::Oversampling<float>>, maxOversamplingOrder> oversamplers;
+    juce::dsp::LookupTableTransform<float> tanhTable;
+};
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    Packs a chain ordering into a single word so it can be handed between
+    threads with one atomic store and one atomic load.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace PackedOrder
+{
+    constexpr size_t bitsPerSlot = 3;
+    constexpr uint32_t slotMask = (1u << bitsPerSlot) - 1;
+
+    template<typename Option, size_t NumSlots>
+    constexpr uint32_t pack(const std::array<Option, NumSlots>& order) {
+        static_assert(NumSlots * bitsPerSlot <= 32, "Order doesn't fit in one word");
+
+        uint32_t word = 0;
+
+        for (size_t i = 0; i < NumSlots; ++i)
+            word |= (static_cast<uint32_t>(order[i]) & slotMask) << (i * bitsPerSlot);
+
+        return word;
+    }
+
+    template<typename Option, size_t NumSlots>
+    constexpr std::array<Option, NumSlots> unpack(uint32_t word) {
+        std::array<Option, NumSlots> order{};
+
+        for (size_t i = 0; i < NumSlots; ++i)
+            order[i] = static_cast<Option>((word >> (i * bitsPerSlot)) & slotMask);
+
+        return order;
+    }
+
+    static_assert(unpack<size_t, 5>(pack(std::array<size_t, 5> { 4, 2, 0, 1, 3 })) == std::array<size_t, 5> { 4, 2, 0, 1, 3 });
+    static_assert(pack(std::array<size_t, 5> { 0, 0, 0, 0, 0 }) != pack(std::array<size_t, 5> { 0, 1, 2, 3, 4 }));
+}
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    Hands the audio thread's samples to a spectrum analyser on another thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+/** Copies each block, mixed down to mono, into a single-reader FIFO.
+
+    The audio thread does nothing but the copy, and nothing at all while no
+    analyser is attached. When the reader falls behind and the FIFO fills,
+    the newest samples are dropped; the reader only ever looks at the most
+    recent window anyway.
+*/
+class SpectrumTap
+{
+public:
+    // The analyser only looks at the latest window, so the FIFO holds a few
+    // of them: enough for a 30 Hz display refresh at 192 kHz.
+    static constexpr int windowOrder = 11;
+    static constexpr int windowSize = 1 << windowOrder;
+    static constexpr int capacity = 4 * windowSize;
+
+    SpectrumTap() : samples(static_cast<size_t>(capacity)) {}
+
+    void prepare(double newSampleRate) { sampleRate.store(newSampleRate); }
+
+    /** Audio thread only. */
+    void push(const juce::dsp::AudioBlock<float>& block) noexcept {
+        auto numChannels = block.getNumChannels();
+
+        if (numReaders.load(std::memory_order_relaxed) == 0 || numChannels == 0)
+            return;
+
+        auto numSamples = juce::jmin(static_cast<int>(block.getNumSamples()), fifo.getFreeSpace());
+        auto gain = 1.f / static_cast<float>(numChannels);
+        auto scope = fifo.write(numSamples);
+
+        auto mixDown = [&](int start, int size, int offset) {
+            if (size <= 0)
+                return;
+
+            auto* dest = samples.data() + start;
+            juce::FloatVectorOperations::copyWithMultiply(dest, block.getChannelPointer(0) + offset, gain, size);
+
+            for (size_t ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(dest, block.getChannelPointer(ch) + offset, gain, size);
+        };
+
+        mixDown(scope.startIndex1, scope.blockSize1, 0);
+        mixDown(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+    }
+
+    /** Any thread. While no reader is attached, push() returns straight away. */
+    void attachReader() noexcept { ++numReaders; }
+    void detachReader() noexcept { --numReaders; }
+
+    /** The attached reader only: hands the queued samples to the callback in
+        at most two contiguous runs, oldest first, and returns how many there were.
+    */
+    template<typename Callback>
+    int read(Callback&& callback) {
+        auto scope = fifo.read(fifo.getNumReady());
+
+        if (scope.blockSize1 > 0)
+            callback(samples.data() + scope.startIndex1, scope.blockSize1);
+
+        if (scope.blockSize2 > 0)
+            callback(samples.data() + scope.startIndex2, scope.blockSize2);
+
+        return scope.blockSize1 + scope.blockSize2;
+    }
+
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::vector<float> samples;
+    std::atomic<int> numReaders { 0 };
+    std::atomic<double> sampleRate { 44100.0 };
+};
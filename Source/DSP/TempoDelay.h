@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    Feedback delay with a fractional, smoothly changing delay time.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "ChannelLanes.h"
+
+/** Feedback delay for any number of channels, with a one-pole low-pass
+    damping the feedback path.
+
+    The ring buffer is sized in prepare() for maxDelaySeconds at the current
+    sample rate, so process() never allocates. Like MultiChannelBiquad, the
+    channels are interleaved into groups of SIMDRegister<float>::size(): every
+    channel shares the same delay time, so the read, interpolation and
+    feedback filter run once per group instead of once per channel.
+
+    reset() doesn't write the ring, which can take seconds of samples, and
+    is called on the audio thread. process() instead clears it behind the
+    write position just before reads can reach it, and a block's worth
+    further each call, so the clearing is spread over the blocks that follow.
+*/
+class TempoDelay
+{
+public:
+    using SIMDFloat = juce::dsp::SIMDRegister<float>;
+    static constexpr size_t numLanes = SIMDFloat::SIMDNumElements;
+
+    enum class Interpolation
+    {
+        Linear,     // cheapest, dulls the highs at fractional delays
+        Lagrange,   // 3rd order, flat much further up
+        Thiran      // 1st-order allpass: flat magnitude, but smears fast time changes
+    };
+
+    static constexpr double maxDelaySeconds = 4.0;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        sampleRate = spec.sampleRate;
+        numChannels = spec.numChannels;
+        numGroups = (numChannels + numLanes - 1) / numLanes;
+        maximumBlockSize = spec.maximumBlockSize;
+
+        // A few extra samples for the interpolators' neighbours, rounded up to
+        // a power of two so the ring index wraps with a mask.
+        auto maxDelaySamples = static_cast<int>(std::ceil(maxDelaySeconds * sampleRate));
+        auto ringSize = static_cast<size_t>(juce::nextPowerOfTwo(maxDelaySamples + 4));
+        ringMask = ringSize - 1;
+
+        ring = juce::dsp::AudioBlock<SIMDFloat>(ringData, numGroups, ringSize);
+        interleaved = juce::dsp::AudioBlock<SIMDFloat>(interleavedData, numGroups, maximumBlockSize);
+        state.resize(numGroups);
+
+        delayPerSample.resize(maximumBlockSize);
+        feedbackPerSample.resize(maximumBlockSize);
+        mixPerSample.resize(maximumBlockSize);
+
+        delaySmoother.reset(sampleRate, 0.05);
+        feedbackSmoother.reset(sampleRate, 0.02);
+        mixSmoother.reset(sampleRate, 0.02);
+        updateDampingCoefficient();
+
+        reset();
+    }
+
+    void reset() {
+        for (auto& s : state)
+            s = {};
+
+        // Nothing behind the write position counts as silence until process() clears it.
+        writePos = 0;
+        numClearSamples = 0;
+
+        delaySmoother.setCurrentAndTargetValue(getDelayInSamples());
+        feedbackSmoother.setCurrentAndTargetValue(feedback);
+        mixSmoother.setCurrentAndTargetValue(mix);
+    }
+
+    /** Clamped to [2 samples, maxDelaySeconds]; changes glide over 50 ms. */
+    void setDelay(double newDelaySeconds) {
+        delaySeconds = juce::jlimit(0.0, maxDelaySeconds, newDelaySeconds);
+        delaySmoother.setTargetValue(getDelayInSamples());
+    }
+
+    void setFeedback(float newFeedback) {
+        feedback = juce::jlimit(-0.99f, 0.99f, newFeedback);
+        feedbackSmoother.setTargetValue(feedback);
+    }
+
+    void setMix(float newMix) {
+        mix = juce::jlimit(0.f, 1.f, newMix);
+        mixSmoother.setTargetValue(mix);
+    }
+
+    void setDampingFrequency(float newFrequencyHz) {
+        dampingHz = newFrequencyHz;
+        updateDampingCoefficient();
+    }
+
+    void setInterpolation(Interpolation newInterpolation) { interpolation = newInterpolation; }
+
+    /** Roughly the heap memory allocated by prepare(), in bytes. */
+    size_t getAllocatedBytes() const noexcept {
+        return (ring.getNumChannels() * ring.getNumSamples() + interleaved.getNumChannels() * interleaved.getNumSamples()) * sizeof(SIMDFloat)
+             + state.capacity() * sizeof(State)
+             + (delayPerSample.capacity() + feedbackPerSample.capacity() + mixPerSample.capacity()) * sizeof(float);
+    }
+
+    template<typename ProcessContext>
+    void process(const ProcessContext& context) noexcept {
+        const auto& inputBlock = context.getInputBlock();
+        auto& outputBlock = context.getOutputBlock();
+        auto numSamples = outputBlock.getNumSamples();
+        auto numBlockChannels = outputBlock.getNumChannels();
+
+        jassert(numSamples <= maximumBlockSize);
+        jassert(numBlockChannels <= numChannels);
+
+        if (context.isBypassed) {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom(inputBlock);
+
+            return;
+        }
+
+        // The ramps are shared by every channel group, so step them once.
+        auto maxDelay = 0.f;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            delayPerSample[i] = delaySmoother.getNextValue();
+            feedbackPerSample[i] = feedbackSmoother.getNextValue();
+            mixPerSample[i] = mixSmoother.getNextValue();
+            maxDelay = juce::jmax(maxDelay, delayPerSample[i]);
+        }
+
+        // The interpolators read up to 2 samples past the delay.
+        clearRing(static_cast<size_t>(maxDelay) + 3 + numSamples);
+
+        for (size_t group = 0; group * numLanes < numBlockChannels; ++group) {
+            auto* samples = interleaved.getChannelPointer(group);
+            auto* delayed = ring.getChannelPointer(group);
+
+            ChannelLanes::interleave(inputBlock, group, samples);
+
+            switch (interpolation) {
+            case Interpolation::Linear:   processGroup<Interpolation::Linear>(samples, delayed, numSamples, state[group]); break;
+            case Interpolation::Lagrange: processGroup<Interpolation::Lagrange>(samples, delayed, numSamples, state[group]); break;
+            case Interpolation::Thiran:   processGroup<Interpolation::Thiran>(samples, delayed, numSamples, state[group]); break;
+            }
+
+            ChannelLanes::deinterleave(samples, group, outputBlock);
+        }
+
+        writePos = (writePos + numSamples) & ringMask;
+        numClearSamples = juce::jmin(numClearSamples + numSamples, ringMask + 1);
+    }
+
+private:
+    struct State {
+        SIMDFloat lowpass = SIMDFloat::expand(0.f), allpass = SIMDFloat::expand(0.f);
+    };
+
+    template<Interpolation Type>
+    void processGroup(SIMDFloat* samples, SIMDFloat* delayed, size_t numSamples, State& s) noexcept {
+        auto lowpass = s.lowpass, allpass = s.allpass;
+        auto w = writePos;
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            // The write below happens after the read, so delays start at 1 sample.
+            auto delay = delayPerSample[i];
+            auto delayInt = static_cast<size_t>(delay);
+            auto frac = delay - static_cast<float>(delayInt);
+            SIMDFloat wet;
+
+            if constexpr (Type == Interpolation::Linear) {
+                auto s0 = delayed[(w - delayInt) & ringMask];
+                auto s1 = delayed[(w - delayInt - 1) & ringMask];
+                wet = s0 + (s1 - s0) * frac;
+            } else if constexpr (Type == Interpolation::Lagrange) {
+                // Centre the four points on the read position.
+                delayInt -= 1;
+                frac += 1.f;
+
+                auto d1 = frac - 1.f, d2 = frac - 2.f, d3 = frac - 3.f;
+                auto c1 = -d1 * d2 * d3 / 6.f;
+                auto c2 = d2 * d3 * 0.5f;
+                auto c3 = -d1 * d3 * 0.5f;
+                auto c4 = d1 * d2 / 6.f;
+
+                auto s0 = delayed[(w - delayInt) & ringMask];
+                auto s1 = delayed[(w - delayInt - 1) & ringMask];
+                auto s2 = delayed[(w - delayInt - 2) & ringMask];
+                auto s3 = delayed[(w - delayInt - 3) & ringMask];
+                wet = s0 * c1 + (s1 * c2 + s2 * c3 + s3 * c4) * frac;
+            } else {
+                // Keep the allpass coefficient small, where it doesn't ring.
+                if (frac < 0.618f) {
+                    delayInt -= 1;
+                    frac += 1.f;
+                }
+
+                auto alpha = (1.f - frac) / (1.f + frac);
+                auto s0 = delayed[(w - delayInt) & ringMask];
+                auto s1 = delayed[(w - delayInt - 1) & ringMask];
+                wet = s1 + (s0 - allpass) * alpha;
+                allpass = wet;
+            }
+
+            lowpass = lowpass + (wet - lowpass) * dampingCoefficient;
+
+            auto dry = samples[i];
+            delayed[w] = dry + lowpass * feedbackPerSample[i];
+            samples[i] = dry + (wet - dry) * mixPerSample[i];
+
+            w = (w + 1) & ringMask;
+        }
+
+        s.lowpass = lowpass;
+        s.allpass = allpass;
+    }
+
+    /** Zeroes the ring up to length samples behind the write position, from
+        where the last call stopped.
+    */
+    void clearRing(size_t length) noexcept {
+        length = juce::jmin(length, ringMask + 1);
+
+        if (length <= numClearSamples)
+            return;
+
+        for (size_t group = 0; group < numGroups; ++group) {
+            auto* samples = ring.getChannelPointer(group);
+
+            for (size_t i = numClearSamples; i < length; ++i)
+                samples[(writePos - 1 - i) & ringMask] = SIMDFloat::expand(0.f);
+        }
+
+        numClearSamples = length;
+    }
+
+    float getDelayInSamples() const {
+        auto maxDelaySamples = static_cast<float>(maxDelaySeconds * sampleRate);
+        return juce::jlimit(2.f, juce::jmax(2.f, maxDelaySamples), static_cast<float>(delaySeconds * sampleRate));
+    }
+
+    void updateDampingCoefficient() {
+        auto cutoff = juce::jmin(static_cast<double>(dampingHz), sampleRate * 0.49);
+        dampingCoefficient = static_cast<float>(1.0 - std::exp(-juce::MathConstants<double>::twoPi * cutoff / sampleRate));
+    }
+
+    Interpolation interpolation = Interpolation::Lagrange;
+    double delaySeconds = 0.25;
+    float feedback = 0.f, mix = 0.f, dampingHz = 20000.f;
+    float dampingCoefficient = 1.f;
+
+    juce::SmoothedValue<float> delaySmoother, feedbackSmoother, mixSmoother;
+    std::vector<float> delayPerSample, feedbackPerSample, mixPerSample;
+
+    double sampleRate = 44100.0;
+    size_t numChannels = 0, numGroups = 0, maximumBlockSize = 0;
+    size_t ringMask = 0, writePos = 0;
+    size_t numClearSamples = 0;     // behind writePos, written or cleared since reset()
+    std::vector<State> state;
+
+    juce::HeapBlock<char> ringData, interleavedData;
+    juce::dsp::AudioBlock<SIMDFloat> ring, interleaved;
+};
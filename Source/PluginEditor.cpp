@@ -9,13 +9,75 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    constexpr float meterFloorDb = -60.f;
+    constexpr int meterLabelHeight = 20;
+    constexpr int analyzerHeight = 160;
+    constexpr int chainStripHeight = 36;
+    constexpr int timingLabelHeight = ChainProfiler::isEnabled ? 16 : 0;
+    constexpr int timerHz = 30;
+    constexpr int timingUpdateTicks = timerHz / 2;
+
+    juce::String getMeterLabel(JucetutorialsAudioProcessor::DSP_Option option) {
+        using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+
+        switch (option) {
+        case DSP_Option::Phase:         return "Phaser";
+        case DSP_Option::Chorus:        return "Chorus";
+        case DSP_Option::Overdrive:     return "Drive";
+        case DSP_Option::LadderFilter:  return "Ladder";
+        case DSP_Option::GeneralFilter: return "Filter";
+        case DSP_Option::Delay:         return "Delay";
+        case DSP_Option::END_OF_LIST:   break;
+        }
+
+        return {};
+    }
+
+    std::array<juce::String, ChainStrip::numOptions> getChainStripNames() {
+        std::array<juce::String, ChainStrip::numOptions> names;
+
+        for (size_t i = 0; i < names.size(); ++i)
+            names[i] = getMeterLabel(static_cast<JucetutorialsAudioProcessor::DSP_Option>(i));
+
+        return names;
+    }
+}
+
 //==============================================================================
 JucetutorialsAudioProcessorEditor::JucetutorialsAudioProcessorEditor (JucetutorialsAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p),
+      analyzer (p.getPreChainTap(), p.getPostChainTap()),
+      chainStrip (getChainStripNames())
 {
+    audioProcessor.updateFilterResponse();
+    analyzer.setFilterResponse(audioProcessor.getFilterResponse());
+    addAndMakeVisible(analyzer);
+
+    // The graph only reaches the audio thread on drop or menu choice.
+    // An order the other bands can't share instances with is refused, and the strip put back.
+    chainStrip.setGraph(audioProcessor.getGraph());
+    chainStrip.setBands(audioProcessor.getNumBands(), getBandFollowers());
+    chainStrip.onGraphChanged = [this](const auto& graph) {
+        auto band = chainStrip.getShownBand();
+
+        if (! audioProcessor.setGraph(graph, band))
+            chainStrip.setGraph(audioProcessor.getGraph(band));
+    };
+    chainStrip.onBandShown = [this](size_t band) { chainStrip.setGraph(audioProcessor.getGraph(band)); };
+    chainStrip.onBandFollowsFirst = [this](size_t band) {
+        audioProcessor.setBandFollowsFirst(band);
+        chainStrip.setGraph(audioProcessor.getGraph(band));
+    };
+    addAndMakeVisible(chainStrip);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (400, 300 + analyzerHeight + chainStripHeight);
+
+    drawnGraph = audioProcessor.getGraph();
+    startTimerHz(timerHz);
 }
 
 JucetutorialsAudioProcessorEditor::~JucetutorialsAudioProcessorEditor()
@@ -28,13 +90,151 @@ void JucetutorialsAudioProcessorEditor::paint (juce::Graphics& g)
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
 
-    g.setColour (juce::Colours::white);
-    g.setFont (15.0f);
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
+    g.setFont (13.0f);
+
+    for (size_t i = 0; i < getNumDrawnMeters(); ++i) {
+        auto column = getMeterColumn(i);
+        auto bar = getMeterBar(i);
+
+        if (! g.getClipBounds().intersects(column))
+            continue;
+
+        g.setColour(juce::Colours::black);
+        g.fillRect(bar);
+
+        // RMS as a filled bar, peak as a line above it.
+        auto heights = drawnMeters[i];
+        g.setColour(juce::Colours::green);
+        g.fillRect(bar.withTop(bar.getBottom() - heights.rms));
+        g.setColour(juce::Colours::yellow);
+        g.fillRect(bar.getX(), bar.getBottom() - heights.peak, bar.getWidth(), juce::jmin(2, heights.peak));
+
+        juce::String label("In");
+
+        if (i > 0) {
+            auto slot = drawnGraph[i - 1];
+            label = getMeterLabel(slot.option) + (slot.instance > 0 ? " " + juce::String(slot.instance + 1) : juce::String());
+        }
+
+        g.setColour(juce::Colours::white);
+        g.drawFittedText(label, column.removeFromBottom(meterLabelHeight), juce::Justification::centred, 1);
+
+        if constexpr (ChainProfiler::isEnabled) {
+            g.setColour(juce::Colours::lightgrey);
+            g.drawFittedText(drawnTimings[i], getTimingLabel(i), juce::Justification::centred, 1);
+        }
+    }
 }
 
 void JucetutorialsAudioProcessorEditor::resized()
 {
     // This is generally where you'll want to lay out the positions of any
     // subcomponents in your editor..
+    auto area = getLocalBounds();
+    analyzer.setBounds(area.removeFromTop(analyzerHeight).reduced(10, 0).withTrimmedTop(10));
+    chainStrip.setBounds(area.removeFromTop(chainStripHeight).reduced(10, 0).withTrimmedTop(6));
+}
+
+std::uint32_t JucetutorialsAudioProcessorEditor::getBandFollowers() const {
+    std::uint32_t followers = 0;
+
+    for (size_t band = 1; band < JucetutorialsAudioProcessor::maxBands; ++band)
+        if (audioProcessor.doesBandFollowFirst(band))
+            followers |= std::uint32_t(1) << band;
+
+    return followers;
+}
+
+void JucetutorialsAudioProcessorEditor::timerCallback() {
+    // The meters follow band 0's graph, the strip whichever band it shows.
+    auto graph = audioProcessor.getGraph();
+
+    if (graph != drawnGraph) {
+        drawnGraph = graph;
+        repaint();
+    }
+
+    chainStrip.setBands(audioProcessor.getNumBands(), getBandFollowers());
+    chainStrip.setGraph(audioProcessor.getGraph(chainStrip.getShownBand()));
+
+    // Only recomputed when a filter parameter, bypass or the order changed.
+    if (audioProcessor.updateFilterResponse())
+        analyzer.setFilterResponse(audioProcessor.getFilterResponse());
+
+    for (size_t i = 0; i < getNumDrawnMeters(); ++i) {
+        auto heights = getMeterHeights(i);
+
+        if (heights != drawnMeters[i]) {
+            drawnMeters[i] = heights;
+            repaint(getMeterBar(i));
+        }
+    }
+
+    if constexpr (ChainProfiler::isEnabled) {
+        if (++ticksSinceTimings >= timingUpdateTicks) {
+            ticksSinceTimings = 0;
+            updateTimings();
+        }
+    }
+}
+
+ChainProfiler::Stage JucetutorialsAudioProcessorEditor::getMeterStage(size_t index) {
+    return index == 0 ? ChainProfiler::Stage::Block : ChainProfiler::getSlotStage(index - 1);
+}
+
+void JucetutorialsAudioProcessorEditor::updateTimings() {
+    const auto& profiler = audioProcessor.getProfiler();
+
+    for (size_t i = 0; i < getNumDrawnMeters(); ++i) {
+        auto summary = profiler.getSummary(getMeterStage(i));
+        auto& last = lastSummaries[i];
+
+        // Blank when nothing ran since the last update, or the counts were reset.
+        juce::String text;
+
+        if (summary.count > last.count) {
+            auto meanCycles = static_cast<double>(summary.totalCycles - last.totalCycles) / static_cast<double>(summary.count - last.count);
+            text = juce::String(ChainProfiler::cyclesToMicros(meanCycles), 1) + " us";
+        }
+
+        last = summary;
+
+        if (text != drawnTimings[i]) {
+            drawnTimings[i] = text;
+            repaint(getTimingLabel(i));
+        }
+    }
+}
+
+JucetutorialsAudioProcessorEditor::MeterHeights JucetutorialsAudioProcessorEditor::getMeterHeights(size_t index) const {
+    const auto& meter = audioProcessor.getMeter(index);
+    auto barHeight = static_cast<float>(getMeterBar(index).getHeight());
+
+    auto toHeight = [&](float gain) {
+        auto db = juce::Decibels::gainToDecibels(gain, meterFloorDb);
+        return juce::roundToInt(juce::jmap(juce::jmin(db, 0.f), meterFloorDb, 0.f, 0.f, barHeight));
+    };
+
+    return { toHeight(meter.getPeak()), toHeight(meter.getRMS()) };
+}
+
+juce::Rectangle<int> JucetutorialsAudioProcessorEditor::getMeterColumn(size_t index) const {
+    auto area = getLocalBounds().withTrimmedTop(analyzerHeight + chainStripHeight).reduced(10);
+    auto columnWidth = area.getWidth() / static_cast<int>(getNumDrawnMeters());
+
+    return area.withX(area.getX() + static_cast<int>(index) * columnWidth).withWidth(columnWidth);
+}
+
+juce::Rectangle<int> JucetutorialsAudioProcessorEditor::getMeterBar(size_t index) const {
+    auto column = getMeterColumn(index);
+    column.removeFromBottom(meterLabelHeight + timingLabelHeight);
+
+    return column.reduced(column.getWidth() / 4, 0);
+}
+
+juce::Rectangle<int> JucetutorialsAudioProcessorEditor::getTimingLabel(size_t index) const {
+    auto column = getMeterColumn(index);
+    column.removeFromBottom(meterLabelHeight);
+
+    return column.removeFromBottom(timingLabelHeight);
 }
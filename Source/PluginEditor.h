@@ -10,11 +10,14 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyzer.h"
+#include "ChainStrip.h"
 
 //==============================================================================
 /**
 */
-class JucetutorialsAudioProcessorEditor  : public juce::AudioProcessorEditor
+class JucetutorialsAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                            private juce::Timer
 {
 public:
     JucetutorialsAudioProcessorEditor (JucetutorialsAudioProcessor&);
@@ -29,5 +32,40 @@ private:
     // access the processor object that created it.
     JucetutorialsAudioProcessor& audioProcessor;
 
+    SpectrumAnalyzer analyzer;
+    ChainStrip chainStrip;
+
+    // Meters are polled on the timer; only the ones whose drawn height
+    // changed are repainted, and the audio thread is never waited on.
+    void timerCallback() override;
+
+    // Bit b set when band b follows band 0's graph.
+    std::uint32_t getBandFollowers() const;
+
+    struct MeterHeights {
+        int peak = 0, rms = 0;
+        bool operator==(const MeterHeights&) const = default;
+    };
+
+    // One meter for the input and one after each slot of band 0's graph.
+    size_t getNumDrawnMeters() const { return drawnGraph.size() + 1; }
+
+    MeterHeights getMeterHeights(size_t index) const;
+    juce::Rectangle<int> getMeterColumn(size_t index) const;
+    juce::Rectangle<int> getMeterBar(size_t index) const;
+    juce::Rectangle<int> getTimingLabel(size_t index) const;
+
+    // Profiling builds show the mean time of the block (under "In") and of
+    // each slot, averaged over the histogram counts since the last update.
+    static ChainProfiler::Stage getMeterStage(size_t index);
+    void updateTimings();
+
+    std::array<ChainProfiler::Summary, JucetutorialsAudioProcessor::numMeters> lastSummaries;
+    std::array<juce::String, JucetutorialsAudioProcessor::numMeters> drawnTimings;
+    int ticksSinceTimings = 0;
+
+    std::array<MeterHeights, JucetutorialsAudioProcessor::numMeters> drawnMeters;
+    JucetutorialsAudioProcessor::DSP_Graph drawnGraph;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JucetutorialsAudioProcessorEditor)
 };
@@ -14,14 +14,43 @@ auto getPhaserCenterFreqName() { return juce::String("Phaser Center FreqHz"); }
 auto getPhaserDepthName() { return juce::String("Phaser Depth %"); }
 auto getPhaserFeedbackName() { return juce::String("Phaser Feedback %"); }
 auto getPhaserMixName() { return juce::String("Phaser Mix %"); }
+auto getPhaserChannelPhasesName() { return juce::String("Phaser LFO Phase"); }
 
 auto getChorusRateName() { return juce::String("Chorus RateHz"); }
 auto getChorusDepthName() { return juce::String("Chorus Depth %"); }
 auto getChorusCenterDelayName() { return juce::String("Chorus Center Delay Ms"); }
 auto getChorusFeedbackName() { return juce::String("Chorus Feedback %"); }
 auto getChorusMixName() { return juce::String("Chorus Mix %"); }
+auto getChorusChannelPhasesName() { return juce::String("Chorus LFO Phase"); }
+
+auto getChannelPhasesChoices() {
+    return juce::StringArray {
+        "Linked",   // every channel at the same LFO phase
+        "Spread"    // channels spread evenly around the LFO cycle
+    };
+}
 
 auto getOverdriveSaturationName() { return juce::String("Overdrive Saturation"); }
+auto getOverdriveKernelName() { return juce::String("Overdrive Kernel"); }
+auto getOverdriveOversamplingName() { return juce::String("Overdrive Oversampling"); }
+
+auto getOverdriveKernelChoices() {
+    return juce::StringArray {
+        "Tanh",       // std::tanh
+        "Rational",   // rational tanh approximation
+        "Soft Clip",  // cubic polynomial
+        "Table"       // tanh lookup table
+    };
+}
+
+auto getOverdriveOversamplingChoices() {
+    return juce::StringArray {
+        "1x",
+        "2x",
+        "4x",
+        "8x"
+    };
+}
 
 auto getLadderFilterModeName() { return juce::String("Ladder Filter Mode"); }
 auto getLadderFilterCutoffName() { return juce::String("Ladder Filter Cutoff Hz"); }
@@ -48,11 +77,193 @@ auto getGeneralFilterChoices() {
     };
 }
 
+auto getPhaserBypassName() { return juce::String("Phaser Bypass"); }
+auto getChorusBypassName() { return juce::String("Chorus Bypass"); }
+auto getOverdriveBypassName() { return juce::String("Overdrive Bypass"); }
+auto getLadderFilterBypassName() { return juce::String("Ladder Filter Bypass"); }
+auto getGeneralFilterBypassName() { return juce::String("General Filter Bypass"); }
+auto getDelayBypassName() { return juce::String("Delay Bypass"); }
+
 auto getGeneralFilterModeName() { return juce::String("General Filter Mode"); }
 auto getGeneralFilterFreqName() { return juce::String("General Filter Freq Hz"); }
 auto getGeneralFilterQualityName() { return juce::String("General Filter Quality"); }
 auto getGeneralFilterGainName() { return juce::String("General Filter Gain"); }
 
+auto getDelayTimeName() { return juce::String("Delay Time Ms"); }
+auto getDelayFeedbackName() { return juce::String("Delay Feedback %"); }
+auto getDelayMixName() { return juce::String("Delay Mix %"); }
+auto getDelayDampingName() { return juce::String("Delay Damping Hz"); }
+auto getDelaySyncName() { return juce::String("Delay Sync"); }
+auto getDelayNoteName() { return juce::String("Delay Note"); }
+auto getDelayInterpolationName() { return juce::String("Delay Interpolation"); }
+
+auto getLfoRateName(size_t lfo) { return "LFO " + juce::String(lfo + 1) + " Rate Hz"; }
+auto getLfoShapeName(size_t lfo) { return "LFO " + juce::String(lfo + 1) + " Shape"; }
+auto getLfoSyncName(size_t lfo) { return "LFO " + juce::String(lfo + 1) + " Sync"; }
+auto getLfoNoteName(size_t lfo) { return "LFO " + juce::String(lfo + 1) + " Note"; }
+
+auto getEnvelopeAttackName() { return juce::String("Envelope Attack Ms"); }
+auto getEnvelopeReleaseName() { return juce::String("Envelope Release Ms"); }
+
+auto getModulationSourceName(size_t slot) { return "Mod " + juce::String(slot + 1) + " Source"; }
+auto getModulationTargetName(size_t slot) { return "Mod " + juce::String(slot + 1) + " Target"; }
+auto getModulationDepthName(size_t slot) { return "Mod " + juce::String(slot + 1) + " Depth"; }
+auto getModulationControlRateName() { return juce::String("Modulation Control Rate"); }
+
+auto getBandsName() { return juce::String("Bands"); }
+auto getCrossoverFreqName(size_t crossover) { return "Crossover " + juce::String(crossover + 1) + " Hz"; }
+
+auto getLfoShapeChoices() {
+    return juce::StringArray {
+        "Sine",
+        "Triangle",
+        "Saw",
+        "Square"
+    };
+}
+
+auto getBandsChoices() {
+    return juce::StringArray {
+        "Off",
+        "2",
+        "3",
+        "4"
+    };
+}
+
+auto getModulationSourceChoices() {
+    return juce::StringArray {
+        "None",
+        "LFO 1",
+        "LFO 2",
+        "Envelope"
+    };
+}
+
+auto getModulationControlRateChoices() {
+    return juce::StringArray {
+        "16",
+        "32",
+        "64"
+    };
+}
+
+auto getNoteChoices() {
+    return juce::StringArray {
+        "1/32",
+        "1/16T",
+        "1/16",
+        "1/16D",
+        "1/8T",
+        "1/8",
+        "1/8D",
+        "1/4T",
+        "1/4",
+        "1/4D",
+        "1/2",
+        "1/1"
+    };
+}
+
+auto getDelayInterpolationChoices() {
+    return juce::StringArray {
+        "Linear",
+        "Lagrange",
+        "Thiran"
+    };
+}
+
+// Instance 0 keeps the original names, and with them the original IDs;
+// the others append their number: "Chorus Mix %", then "Chorus Mix % 2".
+juce::String getInstanceName(const juce::String& name, size_t instance) {
+    return instance == 0 ? name : name + " " + juce::String(instance + 1);
+}
+
+// Every float parameter of the effect modules, in the order of
+// JucetutorialsAudioProcessor::getFloatSetting().
+auto getModulationTargetNameFuncs() {
+    return std::array {
+        &getPhaserRateName,
+        &getPhaserCenterFreqName,
+        &getPhaserDepthName,
+        &getPhaserFeedbackName,
+        &getPhaserMixName,
+
+        &getChorusRateName,
+        &getChorusDepthName,
+        &getChorusCenterDelayName,
+        &getChorusFeedbackName,
+        &getChorusMixName,
+
+        &getOverdriveSaturationName,
+
+        &getLadderFilterCutoffName,
+        &getLadderFilterResonanceName,
+        &getLadderFilterDriveName,
+
+        &getGeneralFilterFreqName,
+        &getGeneralFilterQualityName,
+        &getGeneralFilterGainName,
+
+        &getDelayTimeName,
+        &getDelayFeedbackName,
+        &getDelayMixName,
+        &getDelayDampingName,
+    };
+}
+
+struct FactoryPreset {
+    juce::String name;
+    JucetutorialsAudioProcessor::DSP_Order order;
+    std::vector<std::pair<juce::String, float>> values;     // plain values; anything missing is left at its default
+};
+
+const std::vector<FactoryPreset>& getFactoryPresets() {
+    using DSP_Option = JucetutorialsAudioProcessor::DSP_Option;
+
+    static const std::vector<FactoryPreset> presets {
+        { "Init",
+          { DSP_Option::Phase, DSP_Option::Chorus, DSP_Option::Overdrive, DSP_Option::LadderFilter, DSP_Option::GeneralFilter, DSP_Option::Delay },
+          {} },
+        { "Wide Chorus",
+          { DSP_Option::GeneralFilter, DSP_Option::Chorus, DSP_Option::Phase, DSP_Option::Overdrive, DSP_Option::LadderFilter, DSP_Option::Delay },
+          { { getChorusRateName(), 0.6f },
+            { getChorusDepthName(), 0.4f },
+            { getChorusMixName(), 0.5f },
+            { getGeneralFilterModeName(), 0.f },
+            { getGeneralFilterFreqName(), 3000.f },
+            { getGeneralFilterGainName(), 2.f },
+            { getDelayBypassName(), 1.f } } },
+        { "Crunch",
+          { DSP_Option::Overdrive, DSP_Option::LadderFilter, DSP_Option::GeneralFilter, DSP_Option::Phase, DSP_Option::Chorus, DSP_Option::Delay },
+          { { getOverdriveSaturationName(), 12.f },
+            { getLadderFilterModeName(), 3.f },
+            { getLadderFilterCutoffName(), 4000.f },
+            { getLadderFilterResonanceName(), 0.3f },
+            { getGeneralFilterFreqName(), 120.f },
+            { getGeneralFilterGainName(), 4.f },
+            { getDelayMixName(), 0.1f } } },
+        { "Phase Sweep",
+          { DSP_Option::Phase, DSP_Option::Overdrive, DSP_Option::Chorus, DSP_Option::LadderFilter, DSP_Option::GeneralFilter, DSP_Option::Delay },
+          { { getPhaserRateName(), 0.1f },
+            { getPhaserDepthName(), 0.8f },
+            { getPhaserFeedbackName(), 0.6f },
+            { getPhaserMixName(), 0.6f },
+            { getDelayBypassName(), 1.f } } },
+        { "Dub Delay",
+          { DSP_Option::Overdrive, DSP_Option::Delay, DSP_Option::LadderFilter, DSP_Option::GeneralFilter, DSP_Option::Phase, DSP_Option::Chorus },
+          { { getOverdriveSaturationName(), 3.f },
+            { getDelaySyncName(), 1.f },
+            { getDelayNoteName(), 6.f },
+            { getDelayFeedbackName(), 0.65f },
+            { getDelayMixName(), 0.4f },
+            { getDelayDampingName(), 2500.f },
+            { getLadderFilterCutoffName(), 6000.f } } },
+    };
+
+    return presets;
+}
+
 //==============================================================================
 JucetutorialsAudioProcessor::JucetutorialsAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -67,27 +278,32 @@ JucetutorialsAudioProcessor::JucetutorialsAudioProcessor()
 #endif
 {
     auto floatParams = std::array {
-        &phaserRateHz,
-        &phaserCenterFreqHz,
-        &phaserDepthPercent,
-        &phaserFeedbackPercent,
-        &phaserMixPercent,
-
-        &chorusRateHz,
-        &chorusDepthPercent,
-        &chorusCenterDelayMs,
-        &chorusFeedbackPercent,
-        &chorusMixPercent,
-
-        &overdriveSaturation,
-
-        &ladderFilterCutoffHz,
-        &ladderFilterResonance,
-        &ladderFilterDrive,
-
-        &generalFilterFreqHz,
-        &generalFilterQuality,
-        &generalFilterGain,
+        &ModuleParameters::phaserRateHz,
+        &ModuleParameters::phaserCenterFreqHz,
+        &ModuleParameters::phaserDepthPercent,
+        &ModuleParameters::phaserFeedbackPercent,
+        &ModuleParameters::phaserMixPercent,
+
+        &ModuleParameters::chorusRateHz,
+        &ModuleParameters::chorusDepthPercent,
+        &ModuleParameters::chorusCenterDelayMs,
+        &ModuleParameters::chorusFeedbackPercent,
+        &ModuleParameters::chorusMixPercent,
+
+        &ModuleParameters::overdriveSaturation,
+
+        &ModuleParameters::ladderFilterCutoffHz,
+        &ModuleParameters::ladderFilterResonance,
+        &ModuleParameters::ladderFilterDrive,
+
+        &ModuleParameters::generalFilterFreqHz,
+        &ModuleParameters::generalFilterQuality,
+        &ModuleParameters::generalFilterGain,
+
+        &ModuleParameters::delayTimeMs,
+        &ModuleParameters::delayFeedbackPercent,
+        &ModuleParameters::delayMixPercent,
+        &ModuleParameters::delayDampingHz,
     };
 
     auto floatNameFuncs = std::array {
@@ -112,33 +328,152 @@ JucetutorialsAudioProcessor::JucetutorialsAudioProcessor()
         &getGeneralFilterFreqName,
         &getGeneralFilterQualityName,
         &getGeneralFilterGainName,
-    };
 
-    for (size_t i = 0; i < floatParams.size(); ++i) {
-        auto ptrToParamPtr = floatParams[i];
-        *ptrToParamPtr = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(floatNameFuncs[i]()));
-        jassert(*ptrToParamPtr != nullptr);
-    }
+        &getDelayTimeName,
+        &getDelayFeedbackName,
+        &getDelayMixName,
+        &getDelayDampingName,
+    };
 
     auto choiceParams = std::array {
-        &ladderFilterMode,
-        &generalFilterMode,
+        &ModuleParameters::phaserChannelPhases,
+        &ModuleParameters::chorusChannelPhases,
+        &ModuleParameters::overdriveKernel,
+        &ModuleParameters::overdriveOversampling,
+        &ModuleParameters::ladderFilterMode,
+        &ModuleParameters::generalFilterMode,
+        &ModuleParameters::delayNote,
+        &ModuleParameters::delayInterpolation,
     };
 
     auto choiceNameFuncs = std::array {
+        &getPhaserChannelPhasesName,
+        &getChorusChannelPhasesName,
+        &getOverdriveKernelName,
+        &getOverdriveOversamplingName,
         &getLadderFilterModeName,
         &getGeneralFilterModeName,
+        &getDelayNoteName,
+        &getDelayInterpolationName,
+    };
+
+    auto boolParams = std::array {
+        &ModuleParameters::phaserBypass,
+        &ModuleParameters::chorusBypass,
+        &ModuleParameters::overdriveBypass,
+        &ModuleParameters::ladderFilterBypass,
+        &ModuleParameters::generalFilterBypass,
+        &ModuleParameters::delayBypass,
+        &ModuleParameters::delaySync,
+    };
+
+    auto boolNameFuncs = std::array {
+        &getPhaserBypassName,
+        &getChorusBypassName,
+        &getOverdriveBypassName,
+        &getLadderFilterBypassName,
+        &getGeneralFilterBypassName,
+        &getDelayBypassName,
+        &getDelaySyncName,
     };
 
-    for (size_t i = 0; i < choiceParams.size(); ++i) {
-        auto ptrToParamPtr = choiceParams[i];
-        *ptrToParamPtr = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(choiceNameFuncs[i]()));
-        jassert(*ptrToParamPtr != nullptr);
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        auto& parameters = moduleParameters[instance];
+
+        for (size_t i = 0; i < floatParams.size(); ++i) {
+            auto& param = parameters.*floatParams[i];
+            param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(getInstanceName(floatNameFuncs[i](), instance)));
+            jassert(param != nullptr);
+        }
+
+        for (size_t i = 0; i < choiceParams.size(); ++i) {
+            auto& param = parameters.*choiceParams[i];
+            param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(getInstanceName(choiceNameFuncs[i](), instance)));
+            jassert(param != nullptr);
+        }
+
+        for (size_t i = 0; i < boolParams.size(); ++i) {
+            auto& param = parameters.*boolParams[i];
+            param = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(getInstanceName(boolNameFuncs[i](), instance)));
+            jassert(param != nullptr);
+        }
+    }
+
+    auto getFloat = [this](const juce::String& name) {
+        auto* param = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter(name));
+        jassert(param != nullptr);
+        return param;
+    };
+
+    auto getChoice = [this](const juce::String& name) {
+        auto* param = dynamic_cast<juce::AudioParameterChoice*>(apvts.getParameter(name));
+        jassert(param != nullptr);
+        return param;
+    };
+
+    for (size_t i = 0; i < numLfos; ++i) {
+        lfoRateHz[i] = getFloat(getLfoRateName(i));
+        lfoShape[i] = getChoice(getLfoShapeName(i));
+        lfoNote[i] = getChoice(getLfoNoteName(i));
+        lfoSync[i] = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter(getLfoSyncName(i)));
+        jassert(lfoSync[i] != nullptr);
+    }
+
+    envelopeAttackMs = getFloat(getEnvelopeAttackName());
+    envelopeReleaseMs = getFloat(getEnvelopeReleaseName());
+
+    for (size_t i = 0; i < numModulationSlots; ++i) {
+        modulationSource[i] = getChoice(getModulationSourceName(i));
+        modulationTarget[i] = getChoice(getModulationTargetName(i));
+        modulationDepth[i] = getFloat(getModulationDepthName(i));
+    }
+
+    modulationControlRate = getChoice(getModulationControlRateName());
+    numBandsParameter = getChoice(getBandsName());
+
+    for (size_t i = 0; i < crossoverFreqHz.size(); ++i)
+        crossoverFreqHz[i] = getFloat(getCrossoverFreqName(i));
+
+    static_assert(std::tuple_size_v<decltype(getModulationTargetNameFuncs())> == numFloatSettings);
+
+    for (auto nameFunc : getModulationTargetNameFuncs())
+        modulationTargets.push_back(getFloat(nameFunc()));
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance)
+        instances[instance].lastParameters = readParameters(instance);
+
+    for (size_t band = 0; band < maxBands; ++band)
+        packedGraphs[band].store(band == 0 ? appliedLayout.graphs[0] : followsFirstBand);
+
+    applyLayout(appliedLayout);
+
+    for (auto* param : getParameters()) {
+        auto* paramWithID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+        jassert(paramWithID != nullptr);
+        parameterIDHashes.push_back(paramWithID->paramID.hashCode());
     }
+
+    // States before version 4 match parameters by these alone.
+    jassert(std::set<int>(parameterIDHashes.begin(), parameterIDHashes.end()).size() == parameterIDHashes.size());
+
+    for (const auto& preset : getFactoryPresets())
+        programNames.add(preset.name);
+
+    // Modules stay unprepared until prepareToPlay, or until they are enabled.
+    moduleWorker->addClient(*this);
+
+    // Decoding is kept off the constructor so that recalling many instances
+    // stays quick, on the worker every instance shares rather than a thread of its own.
+    moduleWorker->addJob(*this, [this, sampleRate = processSpec.sampleRate] { ensureProgramsDecoded(sampleRate); });
+
+    // Latency changes reach the host from here, never from the audio thread.
+    startTimerHz(10);
 }
 
 JucetutorialsAudioProcessor::~JucetutorialsAudioProcessor()
 {
+    stopTimer();
+    moduleWorker->removeClient(*this);
 }
 
 //==============================================================================
@@ -176,31 +511,41 @@ bool JucetutorialsAudioProcessor::isMidiEffect() const
 
 double JucetutorialsAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load();
 }
 
 int JucetutorialsAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return programNames.size();   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+                                  // so this should be at least 1, even if you're not really implementing programs.
 }
 
 int JucetutorialsAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void JucetutorialsAudioProcessor::setCurrentProgram (int index)
 {
+    if (! juce::isPositiveAndBelow(index, getNumPrograms()))
+        return;
+
+    ensureProgramsDecoded(processSpec.sampleRate);
+    currentProgram = index;
+
+    const auto& program = programs[static_cast<size_t>(index)];
+    loadParameterValues(program.values, program.packedGraphs, &program);
 }
 
 const juce::String JucetutorialsAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return programNames[index];
 }
 
 void JucetutorialsAudioProcessor::changeProgramName (int index, const juce::String& newName)
 {
+    if (juce::isPositiveAndBelow(index, programNames.size()))
+        programNames.set(index, newName);
 }
 
 //==============================================================================
@@ -214,24 +559,131 @@ void JucetutorialsAudioProcessor::prepareToPlay (double sampleRate, int samplesP
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumInputChannels();
 
-    std::vector<juce::dsp::ProcessorBase*> dsp{
-        &phaser,
-        &chorus,
-        &overdrive,
-        &ladderFilter,
-        &generalFilter
-    };
+    processSpec = spec;
+
+    preChainTap.prepare(sampleRate);
+    postChainTap.prepare(sampleRate);
+
+    // The modules see every band of every channel in split mode.
+    auto maxBandChannels = static_cast<int>(spec.numChannels * maxBands);
+    bypassDryBuffer.setSize(maxBandChannels, samplesPerBlock);
+    reorderDryBuffer.setSize(static_cast<int>(spec.numChannels), samplesPerBlock);
+    bandBuffer.setSize(maxBandChannels, samplesPerBlock);
+    stepChannels.resize(static_cast<size_t>(maxBandChannels));
+    splitter.prepare(spec);
+    fadeGains.resize(static_cast<size_t>(samplesPerBlock));
+
+    for (auto& dryDelay : overdriveDryDelays)
+        dryDelay.prepare(static_cast<size_t>(maxBandChannels), Overdrive::getMaximumLatency());
+
+    // A band can be short of every overdrive the slowest one runs.
+    for (auto& bandDelay : bandDelays)
+        bandDelay.prepare(spec.numChannels, static_cast<int>(instancesPerModule) * Overdrive::getMaximumLatency());
+
+    const double smoothingSeconds = 0.05;
+
+    for (auto& state : instances) {
+        for (auto& fade : state.bypassFades)
+            fade.reset(sampleRate, 0.01);
+
+        state.generalFilterFreqSmoother.reset(sampleRate, smoothingSeconds);
+        state.generalFilterQualitySmoother.reset(sampleRate, smoothingSeconds);
+        state.generalFilterGainSmoother.reset(sampleRate, smoothingSeconds);
+    }
+
+    // Start straight on the latest graph and any state loaded before now, without fading.
+    if (reloadsReady.load() == reloadRequests.load()) {
+        appliedReload = reloadsReady.load();
+        pendingProgram.store(nullptr);
+    }
+
+    reorderFade.reset(sampleRate, 0.005);
+    reorderFade.setCurrentAndTargetValue(1.f);
+    reorderPhase = ReorderPhase::Idle;
+    applyLayout(readLayout());
+    updateCrossovers();
+    generalFilterCache.clear();
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        auto& state = instances[instance];
+        state.lastParameters = readParameters(instance);
+        state.generalFilterFreqSmoother.setCurrentAndTargetValue(state.lastParameters.generalFilter.freqHz);
+        state.generalFilterQualitySmoother.setCurrentAndTargetValue(state.lastParameters.generalFilter.quality);
+        state.generalFilterGainSmoother.setCurrentAndTargetValue(state.lastParameters.generalFilter.gainDb);
+    }
+
+    lastHostParameters = instances[0].lastParameters;
+
+    // Only enabled modules in the graph are prepared here; the worker
+    // prepares the others if they are switched on or added, so idle
+    // instances don't hold their buffers.
+    {
+        const juce::ScopedLock lock(moduleLock);
+        moduleSpec = spec;
+
+        auto bandSpec = spec;
+        bandSpec.numChannels *= moduleBands.load();
 
-    for (auto p : dsp) {
-        p->prepare(spec);
-        p->reset();
+        forEachModule(*this, [&](DSP_Option option, size_t instance, auto& module) {
+            auto index = static_cast<size_t>(option);
+            auto& state = instances[instance];
+            auto isEnabled = state.bands[index] != 0 && ! state.lastParameters.bypassed[index];
+
+            if (isEnabled)
+                module.prepare(bandSpec);
+            else
+                module.release();
+
+            module.lifetime.setState(isEnabled ? ModuleLifetime::State::Ready : ModuleLifetime::State::Released);
+            state.moduleActive[index] = isEnabled;
+            state.moduleIdleSamples[index] = 0;
+        });
+    }
+
+    for (auto& meter : meters)
+        meter.reset();
+
+    // One tick per 16 samples at the fastest control rate.
+    auto maxNumTicks = static_cast<size_t>(samplesPerBlock) / 16 + 1;
+
+    for (size_t i = 0; i < numLfos; ++i) {
+        lfos[i].reset();
+        lfoTicks[i].resize(maxNumTicks);
     }
+
+    envelopeFollower.reset();
+    envelopeTicks.resize(maxNumTicks);
+
+    // Programs hold coefficients for one sample rate; redesign them if it changed.
+    ensureProgramsDecoded(sampleRate);
+
+    for (auto& program : programs)
+        if (program.sampleRate != sampleRate)
+            updateProgramCoefficients(program, sampleRate);
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance)
+        updateDSPFromParameters(instance, instances[instance].lastParameters, samplesPerBlock, true);
+
+    // The host reads the latency after prepareToPlay, before the timer could report it.
+    publishLatency();
+
+    silentInputSamples = 0;
+    chainIsAsleep = false;
+    identicalInputSamples = 0;
+    wasCollapsed = false;
 }
 
 void JucetutorialsAudioProcessor::releaseResources()
 {
-    // When playback stops, you can use this as an opportunity to free up any
-    // spare memory, etc.
+    // Every module gives its buffers back; prepareToPlay allocates the
+    // enabled ones again.
+    const juce::ScopedLock lock(moduleLock);
+
+    forEachModule(*this, [&](DSP_Option option, size_t instance, auto& module) {
+        module.release();
+        module.lifetime.setState(ModuleLifetime::State::Released);
+        instances[instance].moduleActive[static_cast<size_t>(option)] = false;
+    });
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -241,12 +693,11 @@ bool JucetutorialsAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout up to maxNumChannels, from mono to 7.1.4 beds: the modules
+    // process channels in SIMD groups and don't care what the channels are.
+    auto outputChannels = layouts.getMainOutputChannelSet();
+
+    if (outputChannels.isDisabled() || outputChannels.size() > maxNumChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -260,23 +711,11 @@ bool JucetutorialsAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
 }
 #endif
 
-juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor::createParameterLayout() {
-    juce::AudioProcessorValueTreeState::ParameterLayout layout;
-
-    // Pseudo-code pattern :
-    // name = nameFunction();
-    // layout.add(std::make_unique<juce::AudioParameterFloat>(
-    //     juce::ParameterID{ name, versionHint },
-    //     name,
-    //     parameterRange,
-    //     defaultValue,
-    //     unitSuffix
-    // ));
-
+void JucetutorialsAudioProcessor::addModuleParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, size_t instance) {
     const int versionHint = 1;
 
     // Phaser rate: 0.01 - 2.0 Hz, default 0.2 Hz
-    auto name = getPhaserRateName();
+    auto name = getInstanceName(getPhaserRateName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 2.f, 0.01f, 1.f),
@@ -284,7 +723,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "Hz"));
 
     // Phaser depth: 0 - 1, default 0.05
-    name = getPhaserDepthName();
+    name = getInstanceName(getPhaserDepthName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 1.f, 0.01f, 1.f),
@@ -292,7 +731,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "%"));
 
     // Phaser center freq: 20 - 20k Hz, default 1000 Hz
-    name = getPhaserCenterFreqName();
+    name = getInstanceName(getPhaserCenterFreqName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 1.f),
@@ -300,7 +739,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "Hz"));
 
     // Phaser feedback: -1 - +1, default 0
-    name = getPhaserFeedbackName();
+    name = getInstanceName(getPhaserFeedbackName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(-1.f, 1.f, 0.01f, 1.f),
@@ -308,15 +747,23 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "%"));
 
     // Phaser mix: 0 - 1, default 0.05
-    name = getPhaserMixName();
+    name = getInstanceName(getPhaserMixName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 1.f, 0.01f, 1.f),
                                                            0.05f,
                                                            "%"));
 
+    // Phaser LFO phase: linked or spread across channels, default linked
+    name = getInstanceName(getPhaserChannelPhasesName(), instance);
+    auto choices = getChannelPhasesChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            0));
+
     // Chorus rate: 0.01 - 100.0 Hz, default 0.2 Hz
-    name = getChorusRateName();
+    name = getInstanceName(getChorusRateName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 100.f, 0.01f, 1.f),
@@ -324,7 +771,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "Hz"));
 
     // Chorus depth: 0 - 1, default 0.05
-    name = getChorusDepthName();
+    name = getInstanceName(getChorusDepthName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 1.f, 0.01f, 1.f),
@@ -332,7 +779,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "%"));
 
     // Chorus center delay: 1 - 100 Ms, default 1000 Hz
-    name = getChorusCenterDelayName();
+    name = getInstanceName(getChorusCenterDelayName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(1.f, 100.f, 0.1f, 1.f),
@@ -340,7 +787,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "%"));
 
     // Chorus feedback: -1 - +1, default 0
-    name = getChorusFeedbackName();
+    name = getInstanceName(getChorusFeedbackName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(-1.f, 1.f, 0.01f, 1.f),
@@ -348,31 +795,55 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "%"));
 
     // Chorus mix: 0 - 1, default 0.05
-    name = getChorusMixName();
+    name = getInstanceName(getChorusMixName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.01f, 1.f, 0.01f, 1.f),
                                                            0.05f,
                                                            "%"));
 
-    // Overdrive: 1 - 100, uses the drive portion of the ladder filter class for now
-    name = getOverdriveSaturationName();
+    // Chorus LFO phase: linked or spread across channels, default linked
+    name = getInstanceName(getChorusChannelPhasesName(), instance);
+    choices = getChannelPhasesChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            0));
+
+    // Overdrive: 1 - 100, linear drive into the waveshaper
+    name = getInstanceName(getOverdriveSaturationName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(1.f, 100.f, 0.1f, 1.f),
                                                            1.f,
                                                            ""));
 
+    // Overdrive kernel: Overdrive::Kernel enum (int), default rational tanh
+    name = getInstanceName(getOverdriveKernelName(), instance);
+    choices = getOverdriveKernelChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            1));
+
+    // Overdrive oversampling: 1x, 2x, 4x, 8x, default 2x
+    name = getInstanceName(getOverdriveOversamplingName(), instance);
+    choices = getOverdriveOversamplingChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            1));
+
     // Ladder filter mode: LadderFilterMode enum (int)
-    name = getLadderFilterModeName();
-    auto choices = getLadderFilterChoices();
+    name = getInstanceName(getLadderFilterModeName(), instance);
+    choices = getLadderFilterChoices();
     layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
                                                             name,
                                                             choices,
                                                             0));
 
     // Ladder filter cutoff: 20 - 20k Hz
-    name = getLadderFilterCutoffName();
+    name = getInstanceName(getLadderFilterCutoffName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 1.f),
@@ -380,7 +851,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "Hz"));
 
     // Ladder filter resonance: 0 - 1
-    name = getLadderFilterResonanceName();
+    name = getInstanceName(getLadderFilterResonanceName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f),
@@ -388,7 +859,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            ""));
 
     // Ladder filter drive: 1 - 100
-    name = getLadderFilterDriveName();
+    name = getInstanceName(getLadderFilterDriveName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(1.f, 100.f, 0.1f, 1.f),
@@ -396,7 +867,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            ""));
 
     // General filter mode: peak, bandpass, notch, allpass
-    name = getGeneralFilterModeName();
+    name = getInstanceName(getGeneralFilterModeName(), instance);
     choices = getGeneralFilterChoices();
     layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
                                                             name,
@@ -404,7 +875,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                             0));
 
     // General filter freq: 20 - 20k Hz, 1Hz increments
-    name = getGeneralFilterFreqName();
+    name = getInstanceName(getGeneralFilterFreqName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 1.f),
@@ -412,7 +883,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            "Hz"));
 
     // General filter quality: 0.1 - 10, 0.05 increments
-    name = getGeneralFilterQualityName();
+    name = getInstanceName(getGeneralFilterQualityName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(0.1f, 10.f, 0.05f, 1.f),
@@ -420,13 +891,216 @@ juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor:
                                                            ""));
 
     // General filter gain: -24 - +24 dB, 0.5dB increments
-    name = getGeneralFilterGainName();
+    name = getInstanceName(getGeneralFilterGainName(), instance);
     layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
                                                            name,
                                                            juce::NormalisableRange<float>(-24.f, 24.f, 0.5f, 1.f),
                                                            0.f,
                                                            "dB"));
 
+    // Delay time: 1 - 2000 ms, used when not synced to the host tempo
+    name = getInstanceName(getDelayTimeName(), instance);
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(1.f, 2000.f, 0.1f, 0.5f),
+                                                           350.f,
+                                                           "ms"));
+
+    // Delay feedback: 0 - 0.95, default 0.35
+    name = getInstanceName(getDelayFeedbackName(), instance);
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(0.f, 0.95f, 0.01f, 1.f),
+                                                           0.35f,
+                                                           "%"));
+
+    // Delay mix: 0 - 1, default 0.2
+    name = getInstanceName(getDelayMixName(), instance);
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(0.f, 1.f, 0.01f, 1.f),
+                                                           0.2f,
+                                                           "%"));
+
+    // Delay damping: low-pass in the feedback path, 200 - 20k Hz
+    name = getInstanceName(getDelayDampingName(), instance);
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(200.f, 20000.f, 1.f, 0.3f),
+                                                           6000.f,
+                                                           "Hz"));
+
+    // Delay sync: when on, the time follows the host tempo and the note value
+    name = getInstanceName(getDelaySyncName(), instance);
+    layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ name, versionHint },
+                                                          name,
+                                                          false));
+
+    // Delay note: 1/32 to 1/1, with triplets and dotted values, default 1/8
+    name = getInstanceName(getDelayNoteName(), instance);
+    choices = getNoteChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            5));
+
+    // Delay interpolation: TempoDelay::Interpolation enum (int), default Lagrange
+    name = getInstanceName(getDelayInterpolationName(), instance);
+    choices = getDelayInterpolationChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            1));
+}
+
+void JucetutorialsAudioProcessor::addBypassParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, size_t instance) {
+    const int versionHint = 1;
+
+    // Bypass: one per DSP_Option, a bypassed module isn't processed at all
+    auto bypassNameFuncs = std::array {
+        &getPhaserBypassName,
+        &getChorusBypassName,
+        &getOverdriveBypassName,
+        &getLadderFilterBypassName,
+        &getGeneralFilterBypassName,
+        &getDelayBypassName,
+    };
+
+    for (auto nameFunc : bypassNameFuncs) {
+        auto name = getInstanceName(nameFunc(), instance);
+        layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ name, versionHint },
+                                                              name,
+                                                              false));
+    }
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout JucetutorialsAudioProcessor::createParameterLayout() {
+    juce::AudioProcessorValueTreeState::ParameterLayout layout;
+
+    // Pseudo-code pattern :
+    // name = nameFunction();
+    // layout.add(std::make_unique<juce::AudioParameterFloat>(
+    //     juce::ParameterID{ name, versionHint },
+    //     name,
+    //     parameterRange,
+    //     defaultValue,
+    //     unitSuffix
+    // ));
+
+    const int versionHint = 1;
+
+    // The module parameters of instance 0 come first, as they always have.
+    addModuleParameters(layout, 0);
+
+    juce::String name;
+
+    // LFOs: 0.01 - 20 Hz free running, or a note value when synced to the host tempo
+    for (size_t i = 0; i < numLfos; ++i) {
+        name = getLfoRateName(i);
+        layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                               name,
+                                                               juce::NormalisableRange<float>(0.01f, 20.f, 0.01f, 0.4f),
+                                                               1.f,
+                                                               "Hz"));
+
+        name = getLfoShapeName(i);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                                name,
+                                                                getLfoShapeChoices(),
+                                                                0));
+
+        name = getLfoSyncName(i);
+        layout.add(std::make_unique<juce::AudioParameterBool>(juce::ParameterID{ name, versionHint },
+                                                              name,
+                                                              false));
+
+        // Default 1/4
+        name = getLfoNoteName(i);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                                name,
+                                                                getNoteChoices(),
+                                                                8));
+    }
+
+    // Envelope follower attack: 0.1 - 500 ms
+    name = getEnvelopeAttackName();
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(0.1f, 500.f, 0.1f, 0.4f),
+                                                           10.f,
+                                                           "ms"));
+
+    // Envelope follower release: 1 - 2000 ms
+    name = getEnvelopeReleaseName();
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                           name,
+                                                           juce::NormalisableRange<float>(1.f, 2000.f, 1.f, 0.4f),
+                                                           200.f,
+                                                           "ms"));
+
+    // Modulation slots: source, target float parameter and bipolar depth in normalised units
+    juce::StringArray targetChoices;
+
+    for (auto nameFunc : getModulationTargetNameFuncs())
+        targetChoices.add(nameFunc());
+
+    for (size_t i = 0; i < numModulationSlots; ++i) {
+        name = getModulationSourceName(i);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                                name,
+                                                                getModulationSourceChoices(),
+                                                                0));
+
+        name = getModulationTargetName(i);
+        layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                                name,
+                                                                targetChoices,
+                                                                0));
+
+        name = getModulationDepthName(i);
+        layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                               name,
+                                                               juce::NormalisableRange<float>(-1.f, 1.f, 0.01f, 1.f),
+                                                               0.f,
+                                                               ""));
+    }
+
+    // Modulation control rate: sources are evaluated, and targets updated, every 16, 32 or 64 samples
+    name = getModulationControlRateName();
+    auto choices = getModulationControlRateChoices();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            choices,
+                                                            1));
+
+    addBypassParameters(layout, 0);
+
+    // The other instances come last, so instance 0 keeps the parameter
+    // indices it had before there were any.
+    for (size_t instance = 1; instance < instancesPerModule; ++instance) {
+        addModuleParameters(layout, instance);
+        addBypassParameters(layout, instance);
+    }
+
+    // Split mode: off, or 2 - 4 bands split at the first crossovers
+    name = getBandsName();
+    layout.add(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID{ name, versionHint },
+                                                            name,
+                                                            getBandsChoices(),
+                                                            0));
+
+    // Crossovers: 20 - 20000 Hz, each kept above the one before
+    const std::array<float, CrossoverSplitter::numCrossovers> crossoverDefaults { 200.f, 1000.f, 5000.f };
+
+    for (size_t i = 0; i < crossoverDefaults.size(); ++i) {
+        name = getCrossoverFreqName(i);
+        layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID{ name, versionHint },
+                                                               name,
+                                                               juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f),
+                                                               crossoverDefaults[i],
+                                                               "Hz"));
+    }
+
     return layout;
 }
 
@@ -447,48 +1121,679 @@ void JucetutorialsAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
 
     //DONE: add APVTS
     //Done: create audio parameters for all dsp choices
-    //TODO: update DSP here from audio parameters
-    //TODO: save/load settings
-    //TODO: save/load DSP order
-    //TODO: Drag-To-Reorder GUI
+    //DONE: update DSP here from audio parameters
+    //DONE: save/load settings
+    //DONE: save/load DSP order
+    //DONE: Drag-To-Reorder GUI
     //TODO: GUI design for each DSP instance ?
-    //TODO: metering
+    //DONE: metering
     //Done: prepare all DSP
     //TODO: wet/dry knob [BONUS]
     //TODO: mono & stereo versions [mono is BONUS]
-    //TODO: modulators [BONUS]
+    //DONE: modulators [BONUS]
     //TODO: thread-safe filter updating [BONUS]
     //TODO: pre/post filtering [BONUS]
-    //TODO: delay module [BONUS]
+    //DONE: delay module [BONUS]
+
+    ChainProfiler::ScopedTimer blockTimer(profiler, ChainProfiler::Stage::Block);
+
+    auto orderStart = ChainProfiler::readCycles();
+    updateHostTempo();
+    updateReload(buffer.getNumSamples());
+    updateLayout();
+    updateCrossovers();
+    profiler.record(ChainProfiler::Stage::Order, -1, orderStart, ChainProfiler::readCycles());
+
+    // While a program or state is being loaded, keep the old settings until the chain is dry.
+    auto parametersStart = ChainProfiler::readCycles();
+    auto followParameters = ! isReloadPending();
+    auto parameters = followParameters ? readParameters(0) : instances[0].lastParameters;
+    auto modulation = readModulation();
+    auto isModulated = followParameters && modulation.isActive;
+
+    // Host automation only arrives once per block: when a continuous
+    // parameter moved, ramp it across sub-blocks instead of jumping.
+    auto rampStart = lastHostParameters;
+    auto isAutomated = followParameters
+                    && ! isModulated
+                    && buffer.getNumSamples() >= 2 * minimumSubBlockSize.load()
+                    && haveFloatSettingsChanged(parameters, rampStart);
+
+    if (followParameters)
+        lastHostParameters = parameters;
+
+    // The other instances aren't modulated or ramped: they take their
+    // parameters at the start of the block. Their general filters still
+    // glide towards them, stepped on every segment like instance 0's.
+    InstanceParameters otherParameters;
+    auto isOtherFilterGliding = false;
+
+    if (followParameters) {
+        for (size_t instance = 1; instance < instancesPerModule; ++instance) {
+            const auto& state = instances[instance];
+            otherParameters[instance] = readParameters(instance);
+
+            isOtherFilterGliding |= otherParameters[instance].generalFilter != state.lastParameters.generalFilter
+                                 || state.generalFilterFreqSmoother.isSmoothing()
+                                 || state.generalFilterQualitySmoother.isSmoothing()
+                                 || state.generalFilterGainSmoother.isSmoothing();
+        }
+    }
 
-    auto newDSPOrder = DSP_Order();
+    // Segmented blocks update the modules segment by segment instead.
+    auto isSegmented = isModulated
+                    || isAutomated
+                    || (isOtherFilterGliding && buffer.getNumSamples() >= 2 * minimumSubBlockSize.load());
 
-    // Try to pull
-    while (dspOrderFifo.pull(newDSPOrder)) {}
+    if (followParameters && ! isSegmented)
+        for (size_t instance = 0; instance < instancesPerModule; ++instance)
+            updateDSPFromParameters(instance, instance == 0 ? parameters : otherParameters[instance], buffer.getNumSamples(), false);
 
-    // If you pulled, replace dspOrder
-    if (newDSPOrder != DSP_Order())
-        dspOrder = newDSPOrder;
+    updateModuleLifetimes(buffer.getNumSamples());
+    profiler.record(ChainProfiler::Stage::Parameters, -1, parametersStart, ChainProfiler::readCycles());
 
-    // Convert dspOrder into an array of pointers.
-    DSP_Pointers dspPointers;
+    // Skip the chain entirely while asleep; any non-silent input wakes it up.
+    // The meters still fall back to silence rather than freezing where they were.
+    if (isSilent(buffer, totalNumInputChannels)) {
+        silentInputSamples += buffer.getNumSamples();
 
-    for (size_t i = 0; i < dspPointers.size(); ++i) {
-        switch (dspOrder[i]) {
-        case DSP_Option::Phase:
-            dspPointers[i] = &phaser;
-            break;
-        case DSP_Option::Chorus:
-            dspPointers[i] = &chorus;
-            break;
-        case DSP_Option::Overdrive:
-            dspPointers[i] = &overdrive;
-            break;
-        case DSP_Option::LadderFilter:
-            dspPointers[i] = &ladderFilter;
-            break;
-        case DSP_Option::GeneralFilter:
-            dspPointers[i] = &generalFilter;
+        if (chainIsAsleep) {
+            for (auto& meter : meters)
+                meter.decay(static_cast<size_t>(buffer.getNumSamples()), processSpec.sampleRate);
+
+            return;
+        }
+    } else {
+        silentInputSamples = 0;
+        chainIsAsleep = false;
+    }
+
+    // Identical channels through a chain that keeps them identical only need
+    // processing once; the result is copied to the others afterwards.
+    auto isCollapsed = updateMonoCollapse(buffer, totalNumInputChannels, parameters);
+
+    // Process
+    auto block = juce::dsp::AudioBlock<float>(buffer);
+    preChainTap.push(block);
+
+    auto chainBlock = isCollapsed ? block.getSingleChannelBlock(0) : block;
+    auto context = juce::dsp::ProcessContextReplacing<float>(chainBlock);
+
+    if (isSegmented)
+        processSegmented(chainBlock, rampStart, parameters, otherParameters, modulation);
+    else
+        processChain(context);
+
+    if (isCollapsed) {
+        for (int ch = 1; ch < totalNumOutputChannels; ++ch)
+            buffer.copyFrom(ch, 0, buffer, 0, 0, buffer.getNumSamples());
+    } else if (wasCollapsed) {
+        fadeFromFirstChannel(block);
+    }
+
+    wasCollapsed = isCollapsed;
+    postChainTap.push(block);
+
+    // Once the input has been silent for longer than the chain's tail and the
+    // output has decayed too, clear the leftover state and stop processing.
+    if (silentInputSamples > tailLengthSamples && isSilent(buffer, totalNumOutputChannels)) {
+        resetModulesForSleep();
+        chainIsAsleep = true;
+    }
+}
+
+bool JucetutorialsAudioProcessor::setGraph(const DSP_Graph& newGraph, size_t band) {
+    if (band >= maxBands || ! newGraph.isValid())
+        return false;
+
+    PackedGraphs packed;
+
+    for (size_t i = 0; i < maxBands; ++i)
+        packed[i] = packedGraphs[i].load();
+
+    packed[band] = newGraph.pack();
+
+    // Only the bands there are now have to fit together; applyLayout copes
+    // with the others when the band count goes up.
+    if (! DSP_Schedule::build(resolveGraphs(packed), getNumBands()).has_value())
+        return false;
+
+    packedGraphs[band].store(packed[band]);
+    return true;
+}
+
+JucetutorialsAudioProcessor::DSP_Graph JucetutorialsAudioProcessor::getGraph(size_t band) const {
+    if (band >= maxBands || doesBandFollowFirst(band))
+        band = 0;
+
+    return DSP_Graph::unpack(packedGraphs[band].load());
+}
+
+void JucetutorialsAudioProcessor::setDSPOrder(const DSP_Order& newOrder) {
+    auto packed = makeFollowedGraphs(DSP_Graph::fromOrder(newOrder));
+
+    for (size_t band = 0; band < maxBands; ++band)
+        packedGraphs[band].store(packed[band]);
+}
+
+std::array<JucetutorialsAudioProcessor::DSP_Graph, JucetutorialsAudioProcessor::maxBands>
+JucetutorialsAudioProcessor::resolveGraphs(const PackedGraphs& packed) {
+    std::array<DSP_Graph, maxBands> resolved;
+    resolved[0] = DSP_Graph::unpack(packed[0]);
+
+    if (! resolved[0].isValid())
+        resolved[0] = DSP_Graph::fromOrder(defaultDSPOrder);
+
+    for (size_t band = 1; band < maxBands; ++band) {
+        auto graph = DSP_Graph::unpack(packed[band]);
+        resolved[band] = packed[band] == followsFirstBand || ! graph.isValid() ? resolved[0] : graph;
+    }
+
+    return resolved;
+}
+
+JucetutorialsAudioProcessor::PackedGraphs JucetutorialsAudioProcessor::makeFollowedGraphs(const DSP_Graph& first) {
+    PackedGraphs packed;
+    packed.fill(followsFirstBand);
+    packed[0] = first.pack();
+    return packed;
+}
+
+JucetutorialsAudioProcessor::ChainLayout JucetutorialsAudioProcessor::readLayout() const {
+    ChainLayout layout;
+    layout.numBands = getNumBands();
+
+    for (size_t band = 0; band < layout.numBands; ++band)
+        layout.graphs[band] = packedGraphs[band].load();
+
+    return layout;
+}
+
+void JucetutorialsAudioProcessor::updateLayout() {
+    // The only cost when nothing changed: an atomic load per band and a compare.
+    auto layout = readLayout();
+
+    if (layout == appliedLayout && reorderPhase == ReorderPhase::Idle)
+        return;
+
+    if (chainIsAsleep) {
+        applyLayout(layout);
+        reorderPhase = ReorderPhase::Idle;
+        reorderFade.setCurrentAndTargetValue(1.f);
+        return;
+    }
+
+    // A change during a fade just retargets it; the latest layout wins once the chain is dry.
+    if (layout != pendingLayout) {
+        pendingLayout = layout;
+        reorderPhase = ReorderPhase::FadingOut;
+        reorderFade.setTargetValue(0.f);
+    }
+}
+
+void JucetutorialsAudioProcessor::applyLayout(const ChainLayout& layout) {
+    auto bandsChanged = layout.numBands != appliedLayout.numBands;
+
+    appliedLayout = layout;
+    pendingLayout = layout;
+    graphs = resolveGraphs(layout.graphs);
+
+    // The bands may not all fit together after the band count went up, or
+    // from a saved state: those that don't run band 0's graph, which always fits.
+    for (size_t numBands = 2; numBands <= layout.numBands; ++numBands)
+        if (! DSP_Schedule::build(graphs, numBands).has_value())
+            graphs[numBands - 1] = graphs[0];
+
+    schedule = DSP_Schedule::build(graphs, layout.numBands).value_or(DSP_Schedule {});
+
+    // The splitter's band count has to match the block processBands hands it.
+    if (bandsChanged) {
+        updateCrossovers();
+        splitter.reset();
+        bandsChangedSinceFade = true;
+    }
+
+    // The modules are prepared again for the new channel count by updateModuleLifetimes.
+    moduleBands.store(static_cast<juce::uint32>(layout.numBands));
+
+    // Plain orderings of instance 0 keep their specialised chains, as long as every band runs the same one.
+    bandsShareGraph = std::all_of(graphs.begin(), graphs.begin() + static_cast<std::ptrdiff_t>(layout.numBands),
+                                  [this](const DSP_Graph& graph) { return graph == graphs[0]; });
+
+    auto order = graphs[0].getOrder();
+    chainFunction = order.has_value() && bandsShareGraph ? getChainFunction(*order) : nullptr;
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        auto& state = instances[instance];
+
+        for (size_t i = 0; i < numDSPOptions; ++i) {
+            auto option = static_cast<DSP_Option>(i);
+            auto bands = schedule.getBands({ option, instance });
+
+            // An instance joining the chain starts clean, not with what it held
+            // when it left, and so does one whose lanes now carry other bands.
+            if (bands != 0 && bands != state.bands[i])
+                resetModule(option, instance);
+
+            state.bands[i] = bands;
+        }
+    }
+
+    updateTail();
+    updateLatency();
+}
+
+void JucetutorialsAudioProcessor::processChain(const juce::dsp::ProcessContextReplacing<float>& context) {
+    auto& block = context.getOutputBlock();
+    auto isFading = reorderPhase != ReorderPhase::Idle;
+
+    meters[0].process(block, processSpec.sampleRate);
+
+    if (isFading)
+        for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+            reorderDryBuffer.copyFrom(static_cast<int>(ch), 0, block.getChannelPointer(ch), static_cast<int>(block.getNumSamples()));
+
+    if (appliedLayout.numBands > 1)
+        processBands(context);
+    else
+        runChain(context);
+
+    if (! isFading)
+        return;
+
+    mixWithDry(block, reorderDryBuffer, reorderFade);
+
+    if (reorderFade.isSmoothing())
+        return;
+
+    if (reorderPhase == ReorderPhase::FadingOut) {
+        // Fully dry now, so the layout or program can be swapped without a click.
+        if (isReloadPending()) {
+            if (! tryReload(static_cast<int>(block.getNumSamples())))
+                return;     // still being written: stay dry
+        } else if (pendingLayout != appliedLayout) {
+            applyLayout(pendingLayout);
+        }
+
+        // After a change of band count every module is prepared again for
+        // the new channel count: stay dry until they're in. Added instances
+        // don't need waiting for; processModule passes the audio through
+        // until they're ready, then fades them in.
+        if (bandsChangedSinceFade) {
+            if (! areModulesReady())
+                return;
+
+            bandsChangedSinceFade = false;
+        }
+
+        reorderPhase = ReorderPhase::FadingIn;
+        reorderFade.setTargetValue(1.f);
+    } else {
+        reorderPhase = ReorderPhase::Idle;
+    }
+}
+
+void JucetutorialsAudioProcessor::runChain(const juce::dsp::ProcessContextReplacing<float>& context) {
+    if (chainDispatch == ChainDispatch::PointerArray && bandsShareGraph)
+        processChainWithPointers(context);
+    else if (chainFunction != nullptr)
+        chainFunction(*this, context);
+    else
+        processGraph(context);
+}
+
+void JucetutorialsAudioProcessor::processBands(const juce::dsp::ProcessContextReplacing<float>& context) {
+    auto& block = context.getOutputBlock();
+    auto numChannels = block.getNumChannels();
+    auto numBands = appliedLayout.numBands;
+
+    // Every band of every channel runs through the chain at once, so the
+    // modules carry the bands in their SIMD lanes.
+    auto bands = juce::dsp::AudioBlock<float>(bandBuffer)
+                     .getSubsetChannelBlock(0, numChannels * numBands)
+                     .getSubBlock(0, block.getNumSamples());
+
+    splitter.process(block, bands);
+    runChain(juce::dsp::ProcessContextReplacing<float>(bands));
+
+    // Bands with less latency than the slowest are delayed to line up with it.
+    for (size_t band = 0; band < numBands; ++band) {
+        if (bandDelays[band].getDelay() > 0) {
+            auto bandBlock = bands.getSubsetChannelBlock(band * numChannels, numChannels);
+            bandDelays[band].process(bandBlock, bandBlock);
+        }
+    }
+
+    block.copyFrom(bands.getSubsetChannelBlock(0, numChannels));
+
+    for (size_t band = 1; band < numBands; ++band)
+        block.add(bands.getSubsetChannelBlock(band * numChannels, numChannels));
+}
+
+void JucetutorialsAudioProcessor::updateCrossovers() {
+    if (appliedLayout.numBands < 2)
+        return;
+
+    std::array<float, CrossoverSplitter::numCrossovers> frequencies;
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+        frequencies[i] = crossoverFreqHz[i]->get();
+
+    splitter.setCrossovers(appliedLayout.numBands, frequencies);
+}
+
+void JucetutorialsAudioProcessor::mixWithDry(const juce::dsp::AudioBlock<float>& block,
+                                             const juce::AudioBuffer<float>& dryBuffer,
+                                             juce::SmoothedValue<float>& wetGain) {
+    auto numSamples = static_cast<int>(block.getNumSamples());
+    auto* gains = fadeGains.data();
+
+    for (int i = 0; i < numSamples; ++i)
+        gains[i] = wetGain.getNextValue();
+
+    for (size_t ch = 0; ch < block.getNumChannels(); ++ch) {
+        auto* wet = block.getChannelPointer(ch);
+        auto* dry = dryBuffer.getReadPointer(static_cast<int>(ch));
+
+        juce::FloatVectorOperations::subtract(wet, dry, numSamples);
+        juce::FloatVectorOperations::multiply(wet, gains, numSamples);
+        juce::FloatVectorOperations::add(wet, dry, numSamples);
+    }
+}
+
+void JucetutorialsAudioProcessor::updateReload(int numSamples) {
+    if (! isReloadPending())
+        return;
+
+    // Nothing to protect while asleep: load as soon as the request is complete.
+    if (chainIsAsleep) {
+        tryReload(numSamples);
+        return;
+    }
+
+    if (reorderPhase != ReorderPhase::FadingOut) {
+        reorderPhase = ReorderPhase::FadingOut;
+        reorderFade.setTargetValue(0.f);
+    }
+}
+
+bool JucetutorialsAudioProcessor::tryReload(int numSamples) {
+    auto requested = reloadRequests.load();
+
+    if (reloadsReady.load() != requested)
+        return false;
+
+    // One exchange hands over the pre-decoded program, if this was a program change.
+    auto* program = pendingProgram.exchange(nullptr);
+    appliedReload = requested;
+
+    // The chain is dry or asleep, so everything jumps straight to the new values.
+    resetAllModules();
+    applyLayout(readLayout());
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        auto& state = instances[instance];
+        auto parameters = readParameters(instance);
+        state.generalFilterFreqSmoother.setCurrentAndTargetValue(parameters.generalFilter.freqHz);
+        state.generalFilterQualitySmoother.setCurrentAndTargetValue(parameters.generalFilter.quality);
+        state.generalFilterGainSmoother.setCurrentAndTargetValue(parameters.generalFilter.gainDb);
+
+        // Automation may already have moved the filter since the program was published.
+        const GeneralFilterCoefficients* coefficients = nullptr;
+
+        if (instance == 0
+            && program != nullptr
+            && program->sampleRate == processSpec.sampleRate
+            && program->generalFilter == parameters.generalFilter)
+            coefficients = &program->generalFilterCoefficients;
+
+        updateDSPFromParameters(instance, parameters, numSamples, true, coefficients);
+    }
+
+    return true;
+}
+
+void JucetutorialsAudioProcessor::loadParameterValues(const std::vector<float>& values,
+                                                      const PackedGraphs& packed,
+                                                      const Program* program) {
+    auto request = reloadRequests.fetch_add(1) + 1;
+    const auto& params = getParameters();
+
+    jassert(values.size() == static_cast<size_t>(params.size()));
+
+    for (int i = 0; i < params.size(); ++i)
+        if (params[i]->getValue() != values[static_cast<size_t>(i)])
+            params[i]->setValueNotifyingHost(values[static_cast<size_t>(i)]);
+
+    for (size_t band = 0; band < maxBands; ++band)
+        packedGraphs[band].store(packed[band]);
+
+    pendingProgram.store(program);
+    reloadsReady.store(request);
+}
+
+void JucetutorialsAudioProcessor::ensureProgramsDecoded(double sampleRate) {
+    const juce::ScopedLock lock(programsLock);
+
+    if (! programsDecoded.load())
+        decodePrograms(sampleRate);
+}
+
+void JucetutorialsAudioProcessor::decodePrograms(double sampleRate) {
+    const auto& params = getParameters();
+    std::vector<Program> decoded;
+
+    for (const auto& preset : getFactoryPresets()) {
+        Program program;
+        program.packedGraphs = makeFollowedGraphs(DSP_Graph::fromOrder(preset.order));
+
+        for (auto* param : params)
+            program.values.push_back(param->getDefaultValue());
+
+        for (const auto& [paramID, value] : preset.values) {
+            auto* param = apvts.getParameter(paramID);
+            jassert(param != nullptr);
+
+            if (param != nullptr)
+                program.values[static_cast<size_t>(param->getParameterIndex())] = param->convertTo0to1(value);
+        }
+
+        updateProgramCoefficients(program, sampleRate);
+        decoded.push_back(std::move(program));
+    }
+
+    programs = std::move(decoded);
+    programsDecoded.store(true);
+}
+
+void JucetutorialsAudioProcessor::updateProgramCoefficients(Program& program, double sampleRate) const {
+    auto plainValue = [&](juce::RangedAudioParameter* param) {
+        return param->convertFrom0to1(program.values[static_cast<size_t>(param->getParameterIndex())]);
+    };
+
+    const auto& parameters = moduleParameters[0];
+    program.generalFilter.mode = juce::roundToInt(plainValue(parameters.generalFilterMode));
+    program.generalFilter.freqHz = plainValue(parameters.generalFilterFreqHz);
+    program.generalFilter.quality = plainValue(parameters.generalFilterQuality);
+    program.generalFilter.gainDb = plainValue(parameters.generalFilterGain);
+
+    program.sampleRate = sampleRate;
+    program.generalFilterCoefficients = makeGeneralFilterCoefficients(sampleRate, program.generalFilter);
+}
+
+bool JucetutorialsAudioProcessor::isValidOrder(std::uint32_t packedOrder) {
+    return getChainFunction(PackedOrder::unpack<DSP_Option, numDSPOptions>(packedOrder)) != nullptr;
+}
+
+bool JucetutorialsAudioProcessor::updateMonoCollapse(const juce::AudioBuffer<float>& buffer,
+                                                     int numChannels,
+                                                     const ParameterSnapshot& parameters) {
+    // Spread LFOs give each channel its own modulation, so the channels drift apart.
+    auto isSpread = [](int channelPhases, bool bypassed) {
+        return ! bypassed && static_cast<MultiChannelLfo::ChannelPhases>(channelPhases) == MultiChannelLfo::ChannelPhases::Spread;
+    };
+
+    auto decorrelates = false;
+
+    for (auto [option, instance] : graphs[0]) {
+        const auto& slotParameters = instance == 0 ? parameters : instances[instance].lastParameters;
+        auto bypassed = slotParameters.bypassed[static_cast<size_t>(option)];
+
+        if (option == DSP_Option::Phase)
+            decorrelates |= isSpread(slotParameters.phaser.channelPhases, bypassed);
+        else if (option == DSP_Option::Chorus)
+            decorrelates |= isSpread(slotParameters.chorus.channelPhases, bypassed);
+    }
+
+    // The modules keep their spare SIMD lanes in step with the first channel,
+    // which only covers channels sharing its group. Split, the bands take
+    // those lanes instead.
+    if (appliedLayout.numBands > 1
+        || numChannels < 2
+        || numChannels > static_cast<int>(juce::dsp::SIMDRegister<float>::size())
+        || decorrelates
+        || ! areChannelsIdentical(buffer, numChannels)) {
+        identicalInputSamples = 0;
+        return false;
+    }
+
+    // Only collapse once the channels have been identical for longer than the
+    // chain's tail, when everything left over from differing input has died out.
+    identicalInputSamples += buffer.getNumSamples();
+    return identicalInputSamples > tailLengthSamples;
+}
+
+bool JucetutorialsAudioProcessor::areChannelsIdentical(const juce::AudioBuffer<float>& buffer, int numChannels) {
+    // Bit-identical only: memcmp is vectorised and stops at the first difference.
+    auto numBytes = static_cast<size_t>(buffer.getNumSamples()) * sizeof(float);
+    auto* first = buffer.getReadPointer(0);
+
+    for (int ch = 1; ch < numChannels; ++ch)
+        if (std::memcmp(first, buffer.getReadPointer(ch), numBytes) != 0)
+            return false;
+
+    return true;
+}
+
+void JucetutorialsAudioProcessor::fadeFromFirstChannel(const juce::dsp::AudioBlock<float>& block) {
+    // Per-channel state outside the SIMD lanes, like the overdrive's oversampling
+    // filters, is stale after a collapse; start the other channels from the first.
+    auto numSamples = block.getNumSamples();
+    auto* first = block.getChannelPointer(0);
+
+    for (size_t ch = 1; ch < block.getNumChannels(); ++ch) {
+        auto* samples = block.getChannelPointer(ch);
+
+        for (size_t i = 0; i < numSamples; ++i) {
+            auto gain = static_cast<float>(i + 1) / static_cast<float>(numSamples);
+            samples[i] = first[i] + (samples[i] - first[i]) * gain;
+        }
+    }
+}
+
+bool JucetutorialsAudioProcessor::isSilent(const juce::AudioBuffer<float>& buffer, int numChannels) {
+    // findMinAndMax is vectorised, and we stop at the first channel with signal.
+    for (int ch = 0; ch < numChannels; ++ch) {
+        auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(ch), buffer.getNumSamples());
+
+        if (range.getStart() < -silenceThreshold || range.getEnd() > silenceThreshold)
+            return false;
+    }
+
+    return true;
+}
+
+double JucetutorialsAudioProcessor::getTailSeconds(const ParameterSnapshot& parameters, DSP_Option option) {
+    const auto pi = juce::MathConstants<double>::pi;
+    const auto decayToThreshold = std::log(1.0 / silenceThreshold);
+
+    // A loop of the given length recirculating with the given feedback gain.
+    auto feedbackTail = [](double loopSeconds, double feedback) {
+        auto gain = juce::jmin(std::abs(feedback), 0.999);
+
+        if (gain < 1.0e-3)
+            return loopSeconds;
+
+        return loopSeconds * (1.0 + std::log(static_cast<double>(silenceThreshold)) / std::log(gain));
+    };
+
+    // A resonance of the given Q ringing at the given frequency.
+    auto resonanceTail = [&](double freqHz, double quality) {
+        return quality / (pi * freqHz) * decayToThreshold;
+    };
+
+    switch (option) {
+    case DSP_Option::Phase:
+        // Six first-order allpass stages, each delaying by roughly 1 / (pi * fc).
+        return feedbackTail(6.0 / (pi * parameters.phaser.centerFreqHz), parameters.phaser.feedback);
+    case DSP_Option::Chorus:
+        // The modulated delay swings up to about twice the centre delay.
+        return feedbackTail(2.0 * parameters.chorus.centerDelayMs * 0.001, parameters.chorus.feedback);
+    case DSP_Option::Overdrive:
+        return 0.0;
+    case DSP_Option::LadderFilter:
+        return resonanceTail(parameters.ladderFilter.cutoffHz, 0.707 / (1.0 - 0.99 * parameters.ladderFilter.resonance));
+    case DSP_Option::GeneralFilter:
+        return resonanceTail(parameters.generalFilter.freqHz, parameters.generalFilter.quality);
+    case DSP_Option::Delay:
+        return feedbackTail(getDelaySeconds(parameters.delay), parameters.delay.feedback);
+    case DSP_Option::END_OF_LIST:
+        break;
+    }
+
+    jassertfalse;
+    return 0.0;
+}
+
+void JucetutorialsAudioProcessor::updateTail() {
+    // Each band's slots run in series, so their tails add up; the longest band's is the chain's.
+    double total = 0.0;
+
+    for (size_t band = 0; band < appliedLayout.numBands; ++band) {
+        double bandTotal = 0.0;
+
+        for (auto [option, instance] : graphs[band]) {
+            const auto& parameters = instances[instance].lastParameters;
+
+            if (! parameters.bypassed[static_cast<size_t>(option)])
+                bandTotal += getTailSeconds(parameters, option);
+        }
+
+        total = juce::jmax(total, bandTotal);
+    }
+
+    auto tailSeconds = juce::jmin(total, maxTailSeconds);
+    tailLengthSeconds = tailSeconds;
+    tailLengthSamples = static_cast<juce::int64>(std::ceil(tailSeconds * processSpec.sampleRate));
+}
+
+void JucetutorialsAudioProcessor::processChainWithPointers(const juce::dsp::ProcessContextReplacing<float>& context) {
+    // Convert the graph every band shares into an array of pointers.
+    const auto& graph = graphs[0];
+    DSP_Pointers dspPointers;
+    dspPointers.fill(nullptr);
+
+    for (size_t i = 0; i < graph.size(); ++i) {
+        auto [option, instance] = graph[i];
+
+        switch (option) {
+        case DSP_Option::Phase:
+            dspPointers[i] = &phaser[instance];
+            break;
+        case DSP_Option::Chorus:
+            dspPointers[i] = &chorus[instance];
+            break;
+        case DSP_Option::Overdrive:
+            dspPointers[i] = &overdrive[instance];
+            break;
+        case DSP_Option::LadderFilter:
+            dspPointers[i] = &ladderFilter[instance];
+            break;
+        case DSP_Option::GeneralFilter:
+            dspPointers[i] = &generalFilter[instance];
+            break;
+        case DSP_Option::Delay:
+            dspPointers[i] = &delay[instance];
             break;
         case DSP_Option::END_OF_LIST:
             jassertfalse;
@@ -496,15 +1801,884 @@ void JucetutorialsAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
         }
     }
 
-    // Process
-    auto block = juce::dsp::AudioBlock<float>(buffer);
-    auto context = juce::dsp::ProcessContextReplacing<float>(block);
-
-    for (size_t i = 0; i < dspPointers.size(); ++i) {
+    for (size_t i = 0; i < graph.size(); ++i) {
         if (dspPointers[i] != nullptr) {
+            ChainProfiler::ScopedTimer timer(profiler, ChainProfiler::getSlotStage(i), static_cast<int>(graph[i].option));
             dspPointers[i]->process(context);
         }
+
+        meters[i + 1].process(context.getOutputBlock(), processSpec.sampleRate);
+    }
+}
+
+void JucetutorialsAudioProcessor::processGraph(const juce::dsp::ProcessContextReplacing<float>& context) {
+    // Anything but one plain ordering in every band: one switch per step,
+    // then the same inlined module calls as the specialised chains. Each step
+    // runs its instance once over every band using it, packed band by band
+    // into consecutive channels, so the bands share its SIMD lanes.
+    auto& block = context.getOutputBlock();
+    auto numBands = appliedLayout.numBands;
+    auto numChannels = block.getNumChannels() / numBands;
+    auto allBands = (std::uint32_t(1) << numBands) - 1;
+
+    for (const auto& step : schedule) {
+        auto [option, instance] = step.slot;
+        auto stepBlock = block;
+
+        if (step.bands != allBands) {
+            size_t numStepChannels = 0;
+
+            for (size_t band = 0; band < numBands; ++band)
+                if ((step.bands >> band) & 1)
+                    for (auto ch = band * numChannels; ch < (band + 1) * numChannels; ++ch)
+                        stepChannels[numStepChannels++] = block.getChannelPointer(ch);
+
+            stepBlock = juce::dsp::AudioBlock<float>(stepChannels.data(), numStepChannels, block.getNumSamples());
+        }
+
+        juce::dsp::ProcessContextReplacing<float> stepContext(stepBlock);
+        auto slot = (step.bands & 1) != 0 ? graphs[0].indexOf(step.slot) : std::nullopt;
+
+        switch (option) {
+        case DSP_Option::Phase:         processStep<DSP_Option::Phase>(slot, instance, stepContext); break;
+        case DSP_Option::Chorus:        processStep<DSP_Option::Chorus>(slot, instance, stepContext); break;
+        case DSP_Option::Overdrive:     processStep<DSP_Option::Overdrive>(slot, instance, stepContext); break;
+        case DSP_Option::LadderFilter:  processStep<DSP_Option::LadderFilter>(slot, instance, stepContext); break;
+        case DSP_Option::GeneralFilter: processStep<DSP_Option::GeneralFilter>(slot, instance, stepContext); break;
+        case DSP_Option::Delay:         processStep<DSP_Option::Delay>(slot, instance, stepContext); break;
+        case DSP_Option::END_OF_LIST:   jassertfalse; break;
+        }
+    }
+}
+
+JucetutorialsAudioProcessor::ParameterSnapshot JucetutorialsAudioProcessor::readParameters(size_t instance) const {
+    const auto& parameters = moduleParameters[instance];
+    ParameterSnapshot snapshot;
+
+    snapshot.phaser.rateHz = parameters.phaserRateHz->get();
+    snapshot.phaser.centerFreqHz = parameters.phaserCenterFreqHz->get();
+    snapshot.phaser.depth = parameters.phaserDepthPercent->get();
+    snapshot.phaser.feedback = parameters.phaserFeedbackPercent->get();
+    snapshot.phaser.mix = parameters.phaserMixPercent->get();
+    snapshot.phaser.channelPhases = parameters.phaserChannelPhases->getIndex();
+
+    snapshot.chorus.rateHz = parameters.chorusRateHz->get();
+    snapshot.chorus.depth = parameters.chorusDepthPercent->get();
+    snapshot.chorus.centerDelayMs = parameters.chorusCenterDelayMs->get();
+    snapshot.chorus.feedback = parameters.chorusFeedbackPercent->get();
+    snapshot.chorus.mix = parameters.chorusMixPercent->get();
+    snapshot.chorus.channelPhases = parameters.chorusChannelPhases->getIndex();
+
+    snapshot.overdrive.saturation = parameters.overdriveSaturation->get();
+    snapshot.overdrive.kernel = parameters.overdriveKernel->getIndex();
+    snapshot.overdrive.oversampling = parameters.overdriveOversampling->getIndex();
+
+    snapshot.ladderFilter.mode = parameters.ladderFilterMode->getIndex();
+    snapshot.ladderFilter.cutoffHz = parameters.ladderFilterCutoffHz->get();
+    snapshot.ladderFilter.resonance = parameters.ladderFilterResonance->get();
+    snapshot.ladderFilter.drive = parameters.ladderFilterDrive->get();
+
+    snapshot.generalFilter.mode = parameters.generalFilterMode->getIndex();
+    snapshot.generalFilter.freqHz = parameters.generalFilterFreqHz->get();
+    snapshot.generalFilter.quality = parameters.generalFilterQuality->get();
+    snapshot.generalFilter.gainDb = parameters.generalFilterGain->get();
+
+    snapshot.delay.timeMs = parameters.delayTimeMs->get();
+    snapshot.delay.feedback = parameters.delayFeedbackPercent->get();
+    snapshot.delay.mix = parameters.delayMixPercent->get();
+    snapshot.delay.dampingHz = parameters.delayDampingHz->get();
+    snapshot.delay.sync = parameters.delaySync->get();
+    snapshot.delay.note = parameters.delayNote->getIndex();
+    snapshot.delay.interpolation = parameters.delayInterpolation->getIndex();
+    snapshot.delay.bpm = hostBpm;
+
+    for (size_t i = 0; i < numDSPOptions; ++i)
+        snapshot.bypassed[i] = getBypassParameter(static_cast<DSP_Option>(i), instance)->get();
+
+    return snapshot;
+}
+
+void JucetutorialsAudioProcessor::updateDSPFromParameters(size_t instance,
+                                                          const ParameterSnapshot& parameters,
+                                                          int numSamples,
+                                                          bool forceUpdate,
+                                                          const GeneralFilterCoefficients* precomputedGeneralFilter) {
+    auto& state = instances[instance];
+    const auto& lastParameters = state.lastParameters;
+
+    if (forceUpdate || parameters.phaser != lastParameters.phaser)
+        updatePhaser(instance, parameters.phaser);
+
+    if (forceUpdate || parameters.chorus != lastParameters.chorus)
+        updateChorus(instance, parameters.chorus);
+
+    if (forceUpdate || parameters.overdrive != lastParameters.overdrive)
+        updateOverdrive(instance, parameters.overdrive);
+
+    if (forceUpdate || parameters.ladderFilter != lastParameters.ladderFilter)
+        updateLadderFilter(instance, parameters.ladderFilter);
+
+    if (forceUpdate || parameters.delay != lastParameters.delay)
+        updateDelay(instance, parameters.delay);
+
+    if (forceUpdate || parameters.generalFilter != lastParameters.generalFilter) {
+        if (generalFilterModulated && instance == 0) {
+            // Modulation already arrives in control-rate steps: follow it directly.
+            state.generalFilterFreqSmoother.setCurrentAndTargetValue(parameters.generalFilter.freqHz);
+            state.generalFilterQualitySmoother.setCurrentAndTargetValue(parameters.generalFilter.quality);
+            state.generalFilterGainSmoother.setCurrentAndTargetValue(parameters.generalFilter.gainDb);
+            state.generalFilterModeChanged = true;
+        } else {
+            state.generalFilterFreqSmoother.setTargetValue(parameters.generalFilter.freqHz);
+            state.generalFilterQualitySmoother.setTargetValue(parameters.generalFilter.quality);
+            state.generalFilterGainSmoother.setTargetValue(parameters.generalFilter.gainDb);
+            state.generalFilterModeChanged = forceUpdate || parameters.generalFilter.mode != lastParameters.generalFilter.mode;
+        }
+    }
+
+    auto tailChanged = forceUpdate || parameters != lastParameters;
+
+    for (size_t i = 0; i < numDSPOptions; ++i) {
+        auto& fade = state.bypassFades[i];
+        auto isBypassed = parameters.bypassed[i];
+
+        if (forceUpdate) {
+            fade.setCurrentAndTargetValue(isBypassed ? 0.f : 1.f);
+        } else if (isBypassed != lastParameters.bypassed[i]) {
+            // A module's state is frozen while bypassed; clear it before fading
+            // back in so stale tails don't come back with it.
+            if (! isBypassed && fade.getCurrentValue() == 0.f)
+                resetModule(static_cast<DSP_Option>(i), instance);
+
+            fade.setTargetValue(isBypassed ? 0.f : 1.f);
+        }
+    }
+
+    // Bypassing doesn't change the latency: the host would have to realign on every toggle.
+    auto latencyChanged = forceUpdate || parameters.overdrive.oversampling != lastParameters.overdrive.oversampling;
+
+    state.lastParameters = parameters;
+
+    if (tailChanged)
+        updateTail();
+
+    if (latencyChanged) {
+        overdriveDryDelays[instance].setDelay(Overdrive::getOversamplingLatency(static_cast<size_t>(parameters.overdrive.oversampling)));
+        updateLatency();
+    }
+
+    // Steady state: nothing is ramping, so no coefficients are recomputed.
+    if (state.generalFilterModeChanged
+        || state.generalFilterFreqSmoother.isSmoothing()
+        || state.generalFilterQualitySmoother.isSmoothing()
+        || state.generalFilterGainSmoother.isSmoothing()) {
+        state.generalFilterFreqSmoother.skip(numSamples);
+        state.generalFilterQualitySmoother.skip(numSamples);
+        state.generalFilterGainSmoother.skip(numSamples);
+
+        auto& module = generalFilter[instance];
+
+        if (precomputedGeneralFilter == nullptr)
+            updateGeneralFilterCoefficients(instance);
+        else if (module.lifetime.isReady())
+            module.dsp.setCoefficients(*precomputedGeneralFilter);
+
+        state.generalFilterModeChanged = false;
+    }
+}
+
+juce::AudioParameterBool* JucetutorialsAudioProcessor::getBypassParameter(DSP_Option option, size_t instance) const {
+    const auto& parameters = moduleParameters[instance];
+
+    switch (option) {
+    case DSP_Option::Phase:         return parameters.phaserBypass;
+    case DSP_Option::Chorus:        return parameters.chorusBypass;
+    case DSP_Option::Overdrive:     return parameters.overdriveBypass;
+    case DSP_Option::LadderFilter:  return parameters.ladderFilterBypass;
+    case DSP_Option::GeneralFilter: return parameters.generalFilterBypass;
+    case DSP_Option::Delay:         return parameters.delayBypass;
+    case DSP_Option::END_OF_LIST:   break;
+    }
+
+    jassertfalse;
+    return nullptr;
+}
+
+void JucetutorialsAudioProcessor::resetModule(DSP_Option option, size_t instance) {
+    switch (option) {
+    case DSP_Option::Phase:         phaser[instance].reset(); break;
+    case DSP_Option::Chorus:        chorus[instance].reset(); break;
+    case DSP_Option::Overdrive:     overdrive[instance].reset(); break;
+    case DSP_Option::LadderFilter:  ladderFilter[instance].reset(); break;
+    case DSP_Option::GeneralFilter: generalFilter[instance].reset(); break;
+    case DSP_Option::Delay:         delay[instance].reset(); break;
+    case DSP_Option::END_OF_LIST:   jassertfalse; break;
+    }
+}
+
+void JucetutorialsAudioProcessor::resetAllModules() {
+    for (size_t instance = 0; instance < instancesPerModule; ++instance)
+        for (size_t i = 0; i < numDSPOptions; ++i)
+            resetModule(static_cast<DSP_Option>(i), instance);
+
+    splitter.reset();
+}
+
+void JucetutorialsAudioProcessor::resetModulesForSleep() {
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        phaser[instance].reset();
+        overdrive[instance].reset();
+        ladderFilter[instance].reset();
+        generalFilter[instance].reset();
+    }
+
+    splitter.reset();
+}
+
+void JucetutorialsAudioProcessor::updateModuleLifetimes(int numSamples) {
+    auto releaseSamples = static_cast<juce::int64>(moduleReleaseSeconds * processSpec.sampleRate);
+    auto requested = false;
+
+    auto numModuleChannels = static_cast<size_t>(processSpec.numChannels) * appliedLayout.numBands;
+
+    forEachModule(*this, [&](DSP_Option option, size_t instance, auto& module) {
+        auto index = static_cast<size_t>(option);
+        auto& state = instances[instance];
+
+        // Prepared for another band count: given back, then asked for again below once released.
+        if (module.lifetime.isReady() && module.numChannels != numModuleChannels) {
+            state.moduleActive[index] = false;
+            requested |= module.lifetime.requestRelease();
+            return;
+        }
+
+        if (state.bands[index] != 0 && ! state.lastParameters.bypassed[index]) {
+            state.moduleIdleSamples[index] = 0;
+            requested |= module.lifetime.requestPrepare();
+            return;
+        }
+
+        module.lifetime.cancelPrepare();
+
+        // Kept a while in case it's switched straight back on or put back in
+        // the graph, and never mid-fade.
+        if (state.moduleActive[index] && ! state.bypassFades[index].isSmoothing()) {
+            state.moduleIdleSamples[index] += numSamples;
+
+            if (state.moduleIdleSamples[index] > releaseSamples) {
+                state.moduleActive[index] = false;
+                requested |= module.lifetime.requestRelease();
+            }
+        }
+    });
+
+    if (requested) {
+        moduleRequestPending.store(true);
+
+        // Offline, waiting is fine, and a render shouldn't depend on the worker's timing.
+        if (isNonRealtime())
+            serviceModules();
+    }
+
+    forEachModule(*this, [&](DSP_Option option, size_t instance, auto& module) {
+        auto index = static_cast<size_t>(option);
+        auto& state = instances[instance];
+
+        if (! state.moduleActive[index] && module.lifetime.isReady()) {
+            state.moduleActive[index] = true;
+            activateModule(option, instance);
+        }
+    });
+}
+
+bool JucetutorialsAudioProcessor::areModulesReady() const {
+    auto numModuleChannels = static_cast<size_t>(processSpec.numChannels) * appliedLayout.numBands;
+    auto isReady = true;
+
+    forEachModule(*this, [&](DSP_Option option, size_t instance, const auto& module) {
+        auto index = static_cast<size_t>(option);
+        const auto& state = instances[instance];
+
+        if (state.bands[index] != 0 && ! state.lastParameters.bypassed[index])
+            isReady &= module.lifetime.isReady() && module.numChannels == numModuleChannels;
+    });
+
+    return isReady;
+}
+
+void JucetutorialsAudioProcessor::activateModule(DSP_Option option, size_t instance) {
+    auto& state = instances[instance];
+    const auto& parameters = state.lastParameters;
+
+    // A prepared module starts from its defaults: give it the current settings.
+    switch (option) {
+    case DSP_Option::Phase:         updatePhaser(instance, parameters.phaser); break;
+    case DSP_Option::Chorus:        updateChorus(instance, parameters.chorus); break;
+    case DSP_Option::Overdrive:     updateOverdrive(instance, parameters.overdrive); break;
+    case DSP_Option::LadderFilter:  updateLadderFilter(instance, parameters.ladderFilter); break;
+    case DSP_Option::GeneralFilter: updateGeneralFilterCoefficients(instance); break;
+    case DSP_Option::Delay:         updateDelay(instance, parameters.delay); break;
+    case DSP_Option::END_OF_LIST:   jassertfalse; break;
+    }
+
+    auto index = static_cast<size_t>(option);
+    auto& fade = state.bypassFades[index];
+    fade.setCurrentAndTargetValue(0.f);
+    fade.setTargetValue(parameters.bypassed[index] ? 0.f : 1.f);
+    state.moduleIdleSamples[index] = 0;
+}
+
+void JucetutorialsAudioProcessor::serviceModules() {
+    if (! moduleRequestPending.exchange(false))
+        return;
+
+    const juce::ScopedLock lock(moduleLock);
+
+    auto spec = moduleSpec;
+    spec.numChannels *= moduleBands.load();
+
+    forEachModule(*this, [&](DSP_Option, size_t, auto& module) {
+        module.lifetime.servicePrepare([&] { module.prepare(spec); });
+        module.lifetime.serviceRelease([&] { module.release(); });
+    });
+}
+
+JucetutorialsAudioProcessor::MemoryFootprint JucetutorialsAudioProcessor::getMemoryFootprint() const {
+    MemoryFootprint footprint;
+
+    {
+        const juce::ScopedLock lock(moduleLock);
+
+        forEachModule(*this, [&](DSP_Option option, size_t, const auto& module) {
+            auto index = static_cast<size_t>(option);
+            footprint.numPrepared[index] += module.lifetime.isReady() ? 1 : 0;
+            footprint.moduleBytes[index] += module.dsp.getAllocatedBytes();
+        });
+    }
+
+    auto getBufferBytes = [](const juce::AudioBuffer<float>& buffer) {
+        return static_cast<size_t>(buffer.getNumChannels() * buffer.getNumSamples()) * sizeof(float);
+    };
+
+    footprint.chainBytes = getBufferBytes(bypassDryBuffer)
+                         + getBufferBytes(reorderDryBuffer)
+                         + (fadeGains.capacity() + envelopeTicks.capacity()) * sizeof(float)
+                         + generalFilterCache.getAllocatedBytes()
+                         + getBufferBytes(bandBuffer)
+                         + stepChannels.capacity() * sizeof(float*)
+                         + splitter.getAllocatedBytes();
+
+    for (const auto& dryDelay : overdriveDryDelays)
+        footprint.chainBytes += dryDelay.getAllocatedBytes();
+
+    for (const auto& bandDelay : bandDelays)
+        footprint.chainBytes += bandDelay.getAllocatedBytes();
+
+    for (const auto& ticks : lfoTicks)
+        footprint.chainBytes += ticks.capacity() * sizeof(float);
+
+    footprint.analyserBytes = 2 * static_cast<size_t>(SpectrumTap::capacity) * sizeof(float);
+
+    if (programsDecoded.load())
+        for (const auto& program : programs)
+            footprint.programBytes += sizeof(Program) + program.values.capacity() * sizeof(float);
+
+    return footprint;
+}
+
+template<JucetutorialsAudioProcessor::DSP_Option Option>
+void JucetutorialsAudioProcessor::processModule(size_t instance, const juce::dsp::ProcessContextReplacing<float>& context) {
+    auto& fade = instances[instance].bypassFades[static_cast<size_t>(Option)];
+    auto& module = getModule<Option>(instance);
+    auto& block = context.getOutputBlock();
+    auto* dryDelay = getDryDelay(Option, instance);
+
+    // Not prepared yet, already given back, or for fewer bands: pass the audio through.
+    auto canProcess = module.canProcess(block.getNumChannels());
+    auto isFading = canProcess && fade.isSmoothing();
+    auto isWet = isFading || (canProcess && fade.getTargetValue() > 0.f);
+
+    if (dryDelay == nullptr && ! isFading) {
+        if (isWet)
+            module.dsp.process(context);
+
+        return;
+    }
+
+    // Crossfade between the dry input and the module output. A latent
+    // module's dry input is delayed to line up with its output, and is
+    // what it passes through.
+    auto dry = juce::dsp::AudioBlock<float>(bypassDryBuffer)
+                   .getSubsetChannelBlock(0, block.getNumChannels())
+                   .getSubBlock(0, block.getNumSamples());
+
+    if (dryDelay != nullptr)
+        dryDelay->process(block, dry);
+    else
+        dry.copyFrom(block);
+
+    if (isWet)
+        module.dsp.process(context);
+    else
+        block.copyFrom(dry);
+
+    if (isFading)
+        mixWithDry(block, bypassDryBuffer, fade);
+}
+
+void JucetutorialsAudioProcessor::updatePhaser(size_t instance, const PhaserSettings& settings) {
+    auto& module = phaser[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    auto& dsp = module.dsp;
+    dsp.setRate(settings.rateHz);
+    dsp.setCentreFrequency(juce::jmin(settings.centerFreqHz, static_cast<float>(processSpec.sampleRate * 0.49)));
+    dsp.setDepth(settings.depth);
+    dsp.setFeedback(settings.feedback);
+    dsp.setMix(settings.mix);
+    dsp.setChannelPhases(static_cast<MultiChannelPhaser::ChannelPhases>(settings.channelPhases));
+
+    // Split, the bands are extra channels: each band of a channel takes that channel's phase.
+    dsp.setSpreadChannels(processSpec.numChannels);
+}
+
+void JucetutorialsAudioProcessor::updateChorus(size_t instance, const ChorusSettings& settings) {
+    auto& module = chorus[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    auto& dsp = module.dsp;
+    dsp.setRate(settings.rateHz);
+    dsp.setDepth(settings.depth);
+    dsp.setCentreDelay(settings.centerDelayMs);
+    dsp.setFeedback(settings.feedback);
+    dsp.setMix(settings.mix);
+    dsp.setChannelPhases(static_cast<MultiChannelChorus::ChannelPhases>(settings.channelPhases));
+    dsp.setSpreadChannels(processSpec.numChannels);
+}
+
+void JucetutorialsAudioProcessor::updateOverdrive(size_t instance, const OverdriveSettings& settings) {
+    auto& module = overdrive[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    auto& dsp = module.dsp;
+    dsp.setDrive(settings.saturation);
+    dsp.setKernel(static_cast<Overdrive::Kernel>(settings.kernel));
+    dsp.setOversamplingOrder(static_cast<size_t>(settings.oversampling));
+}
+
+LatencyDelay* JucetutorialsAudioProcessor::getDryDelay(DSP_Option option, size_t instance) noexcept {
+    // Only the overdrives' oversampling filters add latency.
+    if (option == DSP_Option::Overdrive && overdriveDryDelays[instance].getDelay() > 0)
+        return &overdriveDryDelays[instance];
+
+    return nullptr;
+}
+
+void JucetutorialsAudioProcessor::updateLatency() {
+    // Each band's slots run in series, so their latencies add up.
+    std::array<int, maxBands> bandLatencies {};
+
+    for (size_t band = 0; band < appliedLayout.numBands; ++band)
+        for (auto [option, instance] : graphs[band])
+            if (auto* dryDelay = getDryDelay(option, instance))
+                bandLatencies[band] += dryDelay->getDelay();
+
+    auto latency = *std::max_element(bandLatencies.begin(), bandLatencies.end());
+
+    for (size_t band = 0; band < maxBands; ++band)
+        bandDelays[band].setDelay(band < appliedLayout.numBands ? latency - bandLatencies[band] : 0);
+
+    chainLatency.store(latency);
+}
+
+void JucetutorialsAudioProcessor::publishLatency() {
+    // setLatencySamples notifies the host, which may lock or post messages.
+    auto latency = chainLatency.load();
+
+    if (latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+void JucetutorialsAudioProcessor::timerCallback() {
+    publishLatency();
+}
+
+void JucetutorialsAudioProcessor::updateLadderFilter(size_t instance, const LadderFilterSettings& settings) {
+    auto& module = ladderFilter[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    configureLadderFilter(module.dsp, settings, processSpec.sampleRate);
+}
+
+void JucetutorialsAudioProcessor::configureLadderFilter(MultiChannelLadder& dsp, const LadderFilterSettings& settings, double sampleRate) {
+    dsp.setMode(static_cast<MultiChannelLadder::Mode>(settings.mode));
+    dsp.setCutoffFrequencyHz(juce::jmin(settings.cutoffHz, static_cast<float>(sampleRate * 0.49)));
+    dsp.setResonance(settings.resonance);
+    dsp.setDrive(settings.drive);
+}
+
+bool JucetutorialsAudioProcessor::updateFilterResponse() {
+    // A handful of atomic loads and a compare when nothing changed.
+    FilterResponseInputs inputs;
+
+    for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+        const auto& parameters = moduleParameters[instance];
+        auto& ladder = inputs.ladderFilter[instance];
+        auto& general = inputs.generalFilter[instance];
+
+        ladder.mode = parameters.ladderFilterMode->getIndex();
+        ladder.cutoffHz = parameters.ladderFilterCutoffHz->get();
+        ladder.resonance = parameters.ladderFilterResonance->get();
+        ladder.drive = parameters.ladderFilterDrive->get();
+        general.mode = parameters.generalFilterMode->getIndex();
+        general.freqHz = parameters.generalFilterFreqHz->get();
+        general.quality = parameters.generalFilterQuality->get();
+        general.gainDb = parameters.generalFilterGain->get();
+        inputs.ladderFilterBypassed[instance] = parameters.ladderFilterBypass->get();
+        inputs.generalFilterBypassed[instance] = parameters.generalFilterBypass->get();
+    }
+
+    inputs.packedGraph = getGraph().pack();
+    inputs.sampleRate = getSampleRate() > 0 ? getSampleRate() : 44100.0;
+
+    if (inputs == filterResponseInputs)
+        return false;
+
+    if (! filterResponseInputs.has_value() || filterResponseInputs->sampleRate != inputs.sampleRate)
+        responseLadder.prepare({ inputs.sampleRate, 1, 1 });
+
+    filterResponseInputs = inputs;
+    filterResponse.prepare(inputs.sampleRate);
+    filterResponse.reset();
+
+    // Every filter in band 0's graph, in any order: the magnitudes multiply.
+    for (auto [option, instance] : DSP_Graph::unpack(inputs.packedGraph)) {
+        if (option == DSP_Option::LadderFilter && ! inputs.ladderFilterBypassed[instance]) {
+            configureLadderFilter(responseLadder, inputs.ladderFilter[instance], inputs.sampleRate);
+            filterResponse.apply(responseLadder);
+        } else if (option == DSP_Option::GeneralFilter && ! inputs.generalFilterBypassed[instance]) {
+            filterResponse.applyBiquad(makeGeneralFilterCoefficients(inputs.sampleRate, inputs.generalFilter[instance]));
+        }
+    }
+
+    return true;
+}
+
+void JucetutorialsAudioProcessor::updateGeneralFilterCoefficients(size_t instance) {
+    auto& module = generalFilter[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    const auto& state = instances[instance];
+    GeneralFilterSettings settings;
+    settings.mode = state.lastParameters.generalFilter.mode;
+    settings.freqHz = state.generalFilterFreqSmoother.getCurrentValue();
+    settings.quality = state.generalFilterQualitySmoother.getCurrentValue();
+    settings.gainDb = state.generalFilterGainSmoother.getCurrentValue();
+
+    // Every instance shares the parameters' steps, and so the cache.
+    auto key = quantizeGeneralFilterSettings(settings);
+    auto sampleRate = processSpec.sampleRate;
+
+    module.dsp.setCoefficients(generalFilterCache.get(key, [&] {
+        return makeGeneralFilterCoefficients(sampleRate, settings);
+    }));
+}
+
+std::uint32_t JucetutorialsAudioProcessor::quantizeGeneralFilterSettings(GeneralFilterSettings& settings) const {
+    // Snaps each value to its parameter's step and packs the step indices:
+    // 2 bits of mode, 15 of frequency, 8 of Q and 7 of gain.
+    auto quantize = [](const juce::AudioParameterFloat* parameter, float& value) {
+        const auto& range = parameter->range;
+        value = range.snapToLegalValue(value);
+        auto index = juce::roundToInt((value - range.start) / range.interval);
+        return static_cast<std::uint32_t>(juce::jmax(0, index));
+    };
+
+    const auto& parameters = moduleParameters[0];
+    auto mode = static_cast<std::uint32_t>(juce::jlimit(0, 3, settings.mode));
+    auto freq = quantize(parameters.generalFilterFreqHz, settings.freqHz);
+    auto quality = quantize(parameters.generalFilterQuality, settings.quality);
+    auto gain = quantize(parameters.generalFilterGain, settings.gainDb);
+
+    jassert(freq < (1u << 15) && quality < (1u << 8) && gain < (1u << 7));
+    return mode | (freq << 2) | (quality << 17) | (gain << 25);
+}
+
+JucetutorialsAudioProcessor::GeneralFilterCoefficients
+JucetutorialsAudioProcessor::makeGeneralFilterCoefficients(double sampleRate, const GeneralFilterSettings& settings) {
+    using Coefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
+    auto freqHz = juce::jmin(settings.freqHz, static_cast<float>(sampleRate * 0.49));
+    auto quality = settings.quality;
+    auto gain = juce::Decibels::decibelsToGain(settings.gainDb);
+
+    // ArrayCoefficients are computed on the stack: no allocation here.
+    switch (settings.mode) {
+    case 0: return Coefficients::makePeakFilter(sampleRate, freqHz, quality, gain);
+    case 1: return Coefficients::makeBandPass(sampleRate, freqHz, quality);
+    case 2: return Coefficients::makeNotch(sampleRate, freqHz, quality);
+    default: return Coefficients::makeAllPass(sampleRate, freqHz, quality);
+    }
+}
+
+void JucetutorialsAudioProcessor::updateDelay(size_t instance, const DelaySettings& settings) {
+    auto& module = delay[instance];
+
+    if (! module.lifetime.isReady())
+        return;
+
+    auto& dsp = module.dsp;
+    dsp.setDelay(getDelaySeconds(settings));
+    dsp.setFeedback(settings.feedback);
+    dsp.setMix(settings.mix);
+    dsp.setDampingFrequency(settings.dampingHz);
+    dsp.setInterpolation(static_cast<TempoDelay::Interpolation>(settings.interpolation));
+}
+
+double JucetutorialsAudioProcessor::getDelaySeconds(const DelaySettings& settings) {
+    if (! settings.sync)
+        return settings.timeMs * 0.001;
+
+    return juce::jmin(getNoteBeats(settings.note) * 60.0 / settings.bpm, TempoDelay::maxDelaySeconds);
+}
+
+double JucetutorialsAudioProcessor::getNoteBeats(int note) {
+    // Length of each getNoteChoices() entry, in quarter notes.
+    static constexpr std::array<double, 12> noteBeats {
+        1.0 / 8.0,
+        1.0 / 6.0, 1.0 / 4.0, 3.0 / 8.0,
+        1.0 / 3.0, 1.0 / 2.0, 3.0 / 4.0,
+        2.0 / 3.0, 1.0, 3.0 / 2.0,
+        2.0,
+        4.0
+    };
+
+    return noteBeats[static_cast<size_t>(juce::jlimit(0, static_cast<int>(noteBeats.size()) - 1, note))];
+}
+
+void JucetutorialsAudioProcessor::updateHostTempo() {
+    hostPpqPosition = {};
+
+    if (auto* playHead = getPlayHead()) {
+        if (auto position = playHead->getPosition()) {
+            if (auto bpm = position->getBpm(); bpm.hasValue() && *bpm > 0.0)
+                hostBpm = *bpm;
+
+            if (position->getIsPlaying())
+                hostPpqPosition = position->getPpqPosition();
+        }
+    }
+}
+
+JucetutorialsAudioProcessor::ModulationSettings JucetutorialsAudioProcessor::readModulation() {
+    ModulationSettings modulation;
+    modulation.controlRate = static_cast<size_t>(16) << modulationControlRate->getIndex();
+
+    for (size_t i = 0; i < numModulationSlots; ++i) {
+        auto& route = modulation.routes[i];
+        route.source = static_cast<ModulationSource>(modulationSource[i]->getIndex());
+        route.target = static_cast<size_t>(modulationTarget[i]->getIndex());
+        route.depth = modulationDepth[i]->get();
+
+        if (route.source == ModulationSource::None || route.depth == 0.f)
+            continue;
+
+        modulation.isActive = true;
+        const auto& parameters = moduleParameters[0];
+        modulation.modulatesGeneralFilter |= modulationTargets[route.target] == parameters.generalFilterFreqHz
+                                          || modulationTargets[route.target] == parameters.generalFilterQuality
+                                          || modulationTargets[route.target] == parameters.generalFilterGain;
+    }
+
+    // Sources only need updating when something listens to them.
+    if (! modulation.isActive)
+        return modulation;
+
+    for (size_t i = 0; i < numLfos; ++i) {
+        auto& lfo = lfos[i];
+        lfo.setShape(static_cast<Lfo::Shape>(lfoShape[i]->getIndex()));
+
+        if (lfoSync[i]->get()) {
+            auto beats = getNoteBeats(lfoNote[i]->getIndex());
+            lfo.setFrequency(hostBpm / 60.0 / beats);
+
+            // Lock the phase to the host's position while it plays.
+            if (hostPpqPosition.hasValue())
+                lfo.setPhase(*hostPpqPosition / beats);
+        } else {
+            lfo.setFrequency(lfoRateHz[i]->get());
+        }
+    }
+
+    envelopeFollower.setAttack(envelopeAttackMs->get());
+    envelopeFollower.setRelease(envelopeReleaseMs->get());
+
+    return modulation;
+}
+
+void JucetutorialsAudioProcessor::processSegmented(const juce::dsp::AudioBlock<float>& block,
+                                                   const ParameterSnapshot& from,
+                                                   const ParameterSnapshot& to,
+                                                   const InstanceParameters& others,
+                                                   const ModulationSettings& modulation) {
+    auto numSamples = block.getNumSamples();
+    auto sampleRate = processSpec.sampleRate;
+
+    // Modulated blocks are cut at every control tick; automated ones into
+    // equal segments of at least the minimum sub-block size.
+    auto controlRate = modulation.controlRate;
+    auto numSegments = modulation.isActive
+                     ? (numSamples + controlRate - 1) / controlRate
+                     : juce::jmax(static_cast<size_t>(1), numSamples / static_cast<size_t>(minimumSubBlockSize.load()));
+
+    auto getSegmentStart = [&](size_t segment) {
+        return modulation.isActive ? juce::jmin(segment * controlRate, numSamples)
+                                   : segment * numSamples / numSegments;
+    };
+
+    if (modulation.isActive) {
+        jassert(numSegments <= envelopeTicks.size());
+
+        // Render every source for the whole block first; the envelope reads the unprocessed input.
+        for (size_t i = 0; i < numLfos; ++i)
+            lfos[i].render(lfoTicks[i].data(), numSegments, controlRate, sampleRate);
+
+        envelopeFollower.render(block, envelopeTicks.data(), numSegments, controlRate, sampleRate);
+    }
+
+    // Modulation is added in the normalised range of each target, then mapped
+    // back. Routes sharing a target add up, collected on the first of them.
+    auto isActive = [](const ModulationRoute& route) { return route.source != ModulationSource::None && route.depth != 0.f; };
+    std::array<size_t, numModulationSlots> firstRoute {};
+
+    for (size_t i = 0; i < numModulationSlots; ++i) {
+        firstRoute[i] = i;
+
+        for (size_t j = 0; j < i; ++j) {
+            if (isActive(modulation.routes[j]) && modulation.routes[j].target == modulation.routes[i].target) {
+                firstRoute[i] = j;
+                break;
+            }
+        }
+    }
+
+    generalFilterModulated = modulation.modulatesGeneralFilter;
+
+    for (size_t segment = 0; segment < numSegments; ++segment) {
+        auto start = getSegmentStart(segment);
+        auto end = getSegmentStart(segment + 1);
+
+        // Continuous parameters ramp from the last block's values to this block's.
+        auto parameters = to;
+        auto amount = static_cast<float>(end) / static_cast<float>(numSamples);
+
+        for (size_t i = 0; i < numFloatSettings; ++i) {
+            auto& value = getFloatSetting(parameters, i);
+            auto startValue = getFloatSetting(from, i);
+            value = startValue + (value - startValue) * amount;
+        }
+
+        if (modulation.isActive) {
+            std::array<float, numModulationSlots> offsets {};
+
+            for (size_t i = 0; i < numModulationSlots; ++i) {
+                const auto& route = modulation.routes[i];
+
+                if (! isActive(route))
+                    continue;
+
+                auto sourceValue = route.source == ModulationSource::Lfo1 ? lfoTicks[0][segment]
+                                 : route.source == ModulationSource::Lfo2 ? lfoTicks[1][segment]
+                                 : envelopeTicks[segment];
+
+                offsets[firstRoute[i]] += route.depth * sourceValue;
+            }
+
+            for (size_t i = 0; i < numModulationSlots; ++i) {
+                const auto& route = modulation.routes[i];
+
+                if (! isActive(route) || firstRoute[i] != i)
+                    continue;
+
+                auto* target = modulationTargets[route.target];
+                auto& value = getFloatSetting(parameters, route.target);
+                value = target->convertFrom0to1(juce::jlimit(0.f, 1.f, target->convertTo0to1(value) + offsets[i]));
+            }
+        }
+
+        updateDSPFromParameters(0, parameters, static_cast<int>(end - start), false);
+
+        for (size_t instance = 1; instance < instancesPerModule; ++instance)
+            updateDSPFromParameters(instance, others[instance], static_cast<int>(end - start), false);
+
+        // getSubBlock only offsets the channel pointers: nothing is copied.
+        auto subBlock = block.getSubBlock(start, end - start);
+        processChain(juce::dsp::ProcessContextReplacing<float>(subBlock));
+    }
+
+    generalFilterModulated = false;
+}
+
+bool JucetutorialsAudioProcessor::haveFloatSettingsChanged(const ParameterSnapshot& a, const ParameterSnapshot& b) {
+    for (size_t i = 0; i < numFloatSettings; ++i)
+        if (getFloatSetting(a, i) != getFloatSetting(b, i))
+            return true;
+
+    return false;
+}
+
+float& JucetutorialsAudioProcessor::getFloatSetting(ParameterSnapshot& parameters, size_t index) {
+    // Same order as getModulationTargetNameFuncs().
+    switch (index) {
+    case 0:  return parameters.phaser.rateHz;
+    case 1:  return parameters.phaser.centerFreqHz;
+    case 2:  return parameters.phaser.depth;
+    case 3:  return parameters.phaser.feedback;
+    case 4:  return parameters.phaser.mix;
+    case 5:  return parameters.chorus.rateHz;
+    case 6:  return parameters.chorus.depth;
+    case 7:  return parameters.chorus.centerDelayMs;
+    case 8:  return parameters.chorus.feedback;
+    case 9:  return parameters.chorus.mix;
+    case 10: return parameters.overdrive.saturation;
+    case 11: return parameters.ladderFilter.cutoffHz;
+    case 12: return parameters.ladderFilter.resonance;
+    case 13: return parameters.ladderFilter.drive;
+    case 14: return parameters.generalFilter.freqHz;
+    case 15: return parameters.generalFilter.quality;
+    case 16: return parameters.generalFilter.gainDb;
+    case 17: return parameters.delay.timeMs;
+    case 18: return parameters.delay.feedback;
+    case 19: return parameters.delay.mix;
+    case 20: return parameters.delay.dampingHz;
+    default: break;
     }
+
+    jassertfalse;
+    return parameters.phaser.rateHz;
+}
+
+JucetutorialsAudioProcessor::ChainFunction JucetutorialsAudioProcessor::getChainFunction(const DSP_Order& order) {
+    static constexpr auto chainFunctions = makeChainFunctions(std::make_index_sequence<numDSPOrders>());
+
+    std::array<size_t, numDSPOptions> permutation;
+
+    for (size_t i = 0; i < permutation.size(); ++i)
+        permutation[i] = static_cast<size_t>(order[i]);
+
+    auto index = ChainPermutations::getPermutationIndex(permutation);
+
+    return index < chainFunctions.size() ? chainFunctions[index] : nullptr;
 }
 
 //==============================================================================
@@ -521,15 +2695,119 @@ juce::AudioProcessorEditor* JucetutorialsAudioProcessor::createEditor()
 //==============================================================================
 void JucetutorialsAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    // Raw binary rather than XML: a few kilobytes that load without any parsing.
+    // The IDs are saved whole, so no two parameters can ever be confused.
+    const auto& params = getParameters();
+    juce::MemoryOutputStream stream(destData, false);
+
+    stream.writeInt(stateMagic);
+    stream.writeShort(stateVersion);
+
+    for (const auto& packed : packedGraphs)
+        stream.writeInt64(static_cast<juce::int64>(packed.load()));
+
+    stream.writeShort(static_cast<short>(currentProgram));
+    stream.writeCompressedInt(params.size());
+
+    for (auto* param : params) {
+        stream.writeString(static_cast<juce::AudioProcessorParameterWithID*>(param)->paramID);
+        stream.writeFloat(param->getValue());
+    }
 }
 
 void JucetutorialsAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    juce::MemoryInputStream stream(data, static_cast<size_t>(juce::jmax(0, sizeInBytes)), false);
+
+    if (stream.getNumBytesRemaining() < 12 || stream.readInt() != stateMagic)
+        return;
+
+    // Parameters are matched by ID, so states from older versions load with
+    // defaults for anything they don't have; newer versions aren't trusted.
+    auto version = stream.readShort();
+
+    if (version > stateVersion)
+        return;
+
+    auto packed = makeFollowedGraphs(DSP_Graph::fromOrder(defaultDSPOrder));
+
+    if (version < 2) {
+        // Instance 0 of every module, in a PackedOrder.
+        auto packedOrder = static_cast<std::uint32_t>(stream.readInt());
+
+        if (isValidOrder(packedOrder))
+            packed[0] = DSP_Graph::fromOrder(PackedOrder::unpack<DSP_Option, numDSPOptions>(packedOrder)).pack();
+    } else if (version < 5) {
+        packed[0] = static_cast<std::uint64_t>(stream.readInt64());
+    } else {
+        for (auto& band : packed)
+            band = static_cast<std::uint64_t>(stream.readInt64());
+    }
+
+    // Every band ran the one graph, less the instances it skipped: bit
+    // (option * 2 + instance) * 4 + band, as versions 3 and 4 laid them out.
+    if (version == 3 || version == 4) {
+        auto bandSkips = static_cast<std::uint64_t>(stream.readInt64());
+        auto shared = DSP_Graph::unpack(packed[0]);
+
+        auto getBandGraph = [&](size_t band) {
+            DSP_Graph graph;
+
+            for (auto slot : shared)
+                if (((bandSkips >> ((static_cast<size_t>(slot.option) * 2 + slot.instance) * 4 + band)) & 1) == 0)
+                    graph.insert(graph.size(), slot);
+
+            return graph;
+        };
+
+        if (bandSkips != 0 && shared.isValid()) {
+            auto first = getBandGraph(0);
+            packed[0] = first.pack();
+
+            for (size_t band = 1; band < maxBands; ++band) {
+                auto graph = getBandGraph(band);
+                packed[band] = graph == first ? followsFirstBand : graph.pack();
+            }
+        }
+    }
+
+    auto program = static_cast<int>(stream.readShort());
+    auto numValues = stream.readCompressedInt();
+
+    const auto& params = getParameters();
+    std::vector<float> values;
+
+    for (auto* param : params)
+        values.push_back(param->getDefaultValue());
+
+    for (int i = 0; i < numValues && stream.getNumBytesRemaining() >= 5; ++i) {
+        auto index = -1;
+
+        if (version < 4) {
+            auto found = std::find(parameterIDHashes.begin(), parameterIDHashes.end(), stream.readInt());
+
+            if (found != parameterIDHashes.end())
+                index = static_cast<int>(std::distance(parameterIDHashes.begin(), found));
+        } else if (auto* param = apvts.getParameter(stream.readString())) {
+            index = param->getParameterIndex();
+        }
+
+        auto value = stream.readFloat();
+
+        if (index >= 0)
+            values[static_cast<size_t>(index)] = juce::jlimit(0.f, 1.f, value);
+    }
+
+    // Invalid graphs load as the default order, or band 0's; bands that don't
+    // fit together are left to applyLayout.
+    auto resolved = resolveGraphs(packed);
+
+    for (size_t band = 0; band < maxBands; ++band)
+        if (packed[band] != followsFirstBand && ! DSP_Graph::unpack(packed[band]).isValid())
+            packed[band] = band == 0 ? resolved[0].pack() : followsFirstBand;
+
+    currentProgram = juce::jlimit(0, getNumPrograms() - 1, program);
+    loadParameterValues(values, packed, nullptr);
 }
 
 //==============================================================================
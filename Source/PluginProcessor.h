@@ -9,7 +9,24 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include <Fifo.h>
+#include "DSP/ChainPermutations.h"
+#include "DSP/ChainGraph.h"
+#include "DSP/MultiChannelBiquad.h"
+#include "DSP/Overdrive.h"
+#include "DSP/PackedOrder.h"
+#include "DSP/TempoDelay.h"
+#include "DSP/LevelMeter.h"
+#include "DSP/ModulationSources.h"
+#include "DSP/MultiChannelPhaser.h"
+#include "DSP/MultiChannelChorus.h"
+#include "DSP/MultiChannelLadder.h"
+#include "DSP/ChainProfiler.h"
+#include "DSP/SpectrumTap.h"
+#include "DSP/FilterResponse.h"
+#include "DSP/CoefficientCache.h"
+#include "DSP/ModuleLifetime.h"
+#include "DSP/CrossoverSplitter.h"
+#include "DSP/LatencyDelay.h"
 
 //==============================================================================
 /**
@@ -18,6 +35,8 @@ class JucetutorialsAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private ModuleWorker::Client
+                             , private juce::Timer
 {
 public:
     //==============================================================================
@@ -32,6 +51,8 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
    #endif
 
+    static constexpr int maxNumChannels = 16;
+
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
@@ -64,6 +85,7 @@ public:
         Overdrive,
         LadderFilter,
         GeneralFilter,
+        Delay,
         END_OF_LIST
     };
 
@@ -73,59 +95,661 @@ public:
 
     using DSP_Order = std::array<DSP_Option, static_cast<size_t>(DSP_Option::END_OF_LIST)>;
 
-    SimpleMBComp::Fifo<DSP_Order> dspOrderFifo;
+    // Every module has a pool of instances, each with its own parameters.
+    // The chain is a graph of up to maxChainSlots slots, each running one
+    // instance, so a module can appear twice, or not at all.
+    static constexpr size_t instancesPerModule = 2;
+    static constexpr size_t maxChainSlots = ChainProfiler::maxSlots;
+
+    using DSP_Graph = ChainGraph<DSP_Option, static_cast<size_t>(DSP_Option::END_OF_LIST), instancesPerModule, maxChainSlots>;
+
+    // Every band runs its own graph; band 0's is the whole chain when split
+    // mode is off. Safe to call from any thread: each graph is packed into
+    // one word and stored atomically, and the audio thread picks it up on its
+    // next block. Returns false, leaving the band as it was, for an invalid
+    // graph or one the other bands can't share their instances with (see
+    // ChainSchedule).
+    bool setGraph(const DSP_Graph& newGraph, size_t band = 0);
+    DSP_Graph getGraph(size_t band = 0) const;
+
+    // Until it's given a graph of its own, a band follows band 0's.
+    void setBandFollowsFirst(size_t band) {
+        if (band > 0 && band < maxBands)
+            packedGraphs[band].store(followsFirstBand);
+    }
+
+    bool doesBandFollowFirst(size_t band) const { return band > 0 && band < maxBands && packedGraphs[band].load() == followsFirstBand; }
+
+    // Instance 0 of every module, in the given order, in every band.
+    void setDSPOrder(const DSP_Order& newOrder);
+
+    // The parameters of one instance of every module. Instance 0 has the
+    // original IDs; the others append the instance number to them.
+    struct ModuleParameters {
+        juce::AudioParameterFloat* phaserRateHz = nullptr;
+        juce::AudioParameterFloat* phaserCenterFreqHz = nullptr;
+        juce::AudioParameterFloat* phaserDepthPercent = nullptr;
+        juce::AudioParameterFloat* phaserFeedbackPercent = nullptr;
+        juce::AudioParameterFloat* phaserMixPercent = nullptr;
+        juce::AudioParameterChoice* phaserChannelPhases = nullptr;
+
+        juce::AudioParameterFloat* chorusRateHz = nullptr;
+        juce::AudioParameterFloat* chorusDepthPercent = nullptr;
+        juce::AudioParameterFloat* chorusCenterDelayMs = nullptr;
+        juce::AudioParameterFloat* chorusFeedbackPercent = nullptr;
+        juce::AudioParameterFloat* chorusMixPercent = nullptr;
+        juce::AudioParameterChoice* chorusChannelPhases = nullptr;
+
+        juce::AudioParameterFloat* overdriveSaturation = nullptr;
+        juce::AudioParameterChoice* overdriveKernel = nullptr;
+        juce::AudioParameterChoice* overdriveOversampling = nullptr;
+
+        juce::AudioParameterChoice* ladderFilterMode = nullptr;
+        juce::AudioParameterFloat* ladderFilterCutoffHz = nullptr;
+        juce::AudioParameterFloat* ladderFilterResonance = nullptr;
+        juce::AudioParameterFloat* ladderFilterDrive = nullptr;
+
+        juce::AudioParameterChoice* generalFilterMode = nullptr;
+        juce::AudioParameterFloat* generalFilterFreqHz = nullptr;
+        juce::AudioParameterFloat* generalFilterQuality = nullptr;
+        juce::AudioParameterFloat* generalFilterGain = nullptr;
+
+        juce::AudioParameterFloat* delayTimeMs = nullptr;
+        juce::AudioParameterFloat* delayFeedbackPercent = nullptr;
+        juce::AudioParameterFloat* delayMixPercent = nullptr;
+        juce::AudioParameterFloat* delayDampingHz = nullptr;
+        juce::AudioParameterBool* delaySync = nullptr;
+        juce::AudioParameterChoice* delayNote = nullptr;
+        juce::AudioParameterChoice* delayInterpolation = nullptr;
+
+        juce::AudioParameterBool* phaserBypass = nullptr;
+        juce::AudioParameterBool* chorusBypass = nullptr;
+        juce::AudioParameterBool* overdriveBypass = nullptr;
+        juce::AudioParameterBool* ladderFilterBypass = nullptr;
+        juce::AudioParameterBool* generalFilterBypass = nullptr;
+        juce::AudioParameterBool* delayBypass = nullptr;
+    };
+
+    std::array<ModuleParameters, instancesPerModule> moduleParameters;
+
+    juce::AudioParameterBool* getBypassParameter(DSP_Option option, size_t instance = 0) const;
+
+    // Modulation matrix: each slot routes one source to one float parameter.
+    static constexpr size_t numLfos = 2;
+    static constexpr size_t numModulationSlots = 4;
+
+    enum class ModulationSource
+    {
+        None,
+        Lfo1,
+        Lfo2,
+        Envelope
+    };
+
+    std::array<juce::AudioParameterFloat*, numLfos> lfoRateHz {};
+    std::array<juce::AudioParameterChoice*, numLfos> lfoShape {};
+    std::array<juce::AudioParameterBool*, numLfos> lfoSync {};
+    std::array<juce::AudioParameterChoice*, numLfos> lfoNote {};
+
+    juce::AudioParameterFloat* envelopeAttackMs = nullptr;
+    juce::AudioParameterFloat* envelopeReleaseMs = nullptr;
+
+    std::array<juce::AudioParameterChoice*, numModulationSlots> modulationSource {};
+    std::array<juce::AudioParameterChoice*, numModulationSlots> modulationTarget {};
+    std::array<juce::AudioParameterFloat*, numModulationSlots> modulationDepth {};
+
+    juce::AudioParameterChoice* modulationControlRate = nullptr;
+
+    // Split mode: the input is split into bands, each running its own graph,
+    // that are summed afterwards. Off is a single band. An instance used by
+    // several bands runs once over all of them, as extra channels in its
+    // SIMD lanes, with the same settings.
+    static constexpr size_t maxBands = CrossoverSplitter::maxBands;
+
+    using DSP_Schedule = ChainSchedule<DSP_Graph, maxBands>;
+
+    juce::AudioParameterChoice* numBandsParameter = nullptr;
+    std::array<juce::AudioParameterFloat*, CrossoverSplitter::numCrossovers> crossoverFreqHz {};
+
+    size_t getNumBands() const { return static_cast<size_t>(numBandsParameter->getIndex()) + 1; }
+
+    enum class ChainDispatch
+    {
+        Specialized,    // one pre-instantiated function per DSP_Order permutation, a switch per slot for other graphs
+        PointerArray    // virtual ProcessorBase calls, kept as a benchmark reference (ignores bypass fades, and only runs when every band shares one graph)
+    };
+
+    void setChainDispatch(ChainDispatch dispatch) { chainDispatch = dispatch; }
+
+    // Blocks in which a continuous parameter moved are split into sub-blocks
+    // of at least this many samples, with the change ramped across them.
+    void setMinimumSubBlockSize(int numSamples) { minimumSubBlockSize = juce::jmax(1, numSamples); }
+
+    // Meter 0 is the chain input, meter i + 1 the output of slot i of band 0's graph.
+    static constexpr size_t numMeters = maxChainSlots + 1;
+    const LevelMeter& getMeter(size_t index) const { return meters[index]; }
 
-    juce::AudioParameterFloat* phaserRateHz = nullptr;
-    juce::AudioParameterFloat* phaserCenterFreqHz = nullptr;
-    juce::AudioParameterFloat* phaserDepthPercent = nullptr;
-    juce::AudioParameterFloat* phaserFeedbackPercent = nullptr;
-    juce::AudioParameterFloat* phaserMixPercent = nullptr;
+    // Stage and slot timings; empty unless built with JUCETUTORIALS_PROFILING.
+    ChainProfiler& getProfiler() { return profiler; }
+    const ChainProfiler& getProfiler() const { return profiler; }
 
-    juce::AudioParameterFloat* chorusRateHz = nullptr;
-    juce::AudioParameterFloat* chorusDepthPercent = nullptr;
-    juce::AudioParameterFloat* chorusCenterDelayMs = nullptr;
-    juce::AudioParameterFloat* chorusFeedbackPercent = nullptr;
-    juce::AudioParameterFloat* chorusMixPercent = nullptr;
+    // The whole bus before and after the chain, for the editor's analyser.
+    SpectrumTap& getPreChainTap() { return preChainTap; }
+    SpectrumTap& getPostChainTap() { return postChainTap; }
 
-    juce::AudioParameterFloat* overdriveSaturation = nullptr;
+    // Message thread only. Recomputes the combined magnitude response of the
+    // ladder and general filters when one of their parameters, their bypass,
+    // the order or the sample rate changed; returns true if it did.
+    bool updateFilterResponse();
+    const FilterResponse& getFilterResponse() const { return filterResponse; }
 
-    juce::AudioParameterChoice* ladderFilterMode = nullptr;
-    juce::AudioParameterFloat* ladderFilterCutoffHz = nullptr;
-    juce::AudioParameterFloat* ladderFilterResonance = nullptr;
-    juce::AudioParameterFloat* ladderFilterDrive = nullptr;
+    // Roughly the heap memory this instance holds, in bytes. Only enabled
+    // modules in the graph keep their buffers; a module bypassed or out of
+    // the graph for moduleReleaseSeconds gives them back. Message thread only.
+    struct MemoryFootprint {
+        std::array<size_t, static_cast<size_t>(DSP_Option::END_OF_LIST)> moduleBytes {};      // every instance of the module
+        std::array<size_t, static_cast<size_t>(DSP_Option::END_OF_LIST)> numPrepared {};      // instances holding their buffers
+        size_t chainBytes = 0;      // dry buffers, modulation ticks, the coefficient cache and the band split
+        size_t analyserBytes = 0;   // the spectrum taps
+        size_t programBytes = 0;    // the decoded factory programs
 
-    juce::AudioParameterChoice* generalFilterMode = nullptr;
-    juce::AudioParameterFloat* generalFilterFreqHz = nullptr;
-    juce::AudioParameterFloat* generalFilterQuality = nullptr;
-    juce::AudioParameterFloat* generalFilterGain = nullptr;
+        size_t getTotalBytes() const {
+            return std::accumulate(moduleBytes.begin(), moduleBytes.end(), chainBytes + analyserBytes + programBytes);
+        }
+    };
+
+    MemoryFootprint getMemoryFootprint() const;
+
+    static constexpr double moduleReleaseSeconds = 2.0;
 
 private:
-    DSP_Order dspOrder;
+    // The parts of createParameterLayout repeated for every instance.
+    static void addModuleParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, size_t instance);
+    static void addBypassParameters(juce::AudioProcessorValueTreeState::ParameterLayout& layout, size_t instance);
+
+    static constexpr DSP_Order defaultDSPOrder {
+        DSP_Option::Phase,
+        DSP_Option::Chorus,
+        DSP_Option::Overdrive,
+        DSP_Option::LadderFilter,
+        DSP_Option::GeneralFilter,
+        DSP_Option::Delay
+    };
+
+    // Never a packed graph: those leave the top bits clear.
+    static constexpr std::uint64_t followsFirstBand = ~std::uint64_t(0);
+
+    using PackedGraphs = std::array<std::uint64_t, maxBands>;
+
+    // Each band's graph as set, followers and all; the constructor fills them in.
+    std::array<std::atomic<std::uint64_t>, maxBands> packedGraphs;
+
+    // Band 0's graph for the followers, and band 0's own if it isn't valid.
+    static std::array<DSP_Graph, maxBands> resolveGraphs(const PackedGraphs& packed);
+    static PackedGraphs makeFollowedGraphs(const DSP_Graph& first);
+
+    // The applied layout's graphs, resolved, and the order to run their instances in.
+    std::array<DSP_Graph, maxBands> graphs;
+    DSP_Schedule schedule;
+    bool bandsShareGraph = true;
+    std::vector<float*> stepChannels;      // a step's bands, when it doesn't run them all
+
+    // Everything that changes what the chain is made of. A new layout fades
+    // the chain out to the dry signal, swaps, then fades back in.
+    struct ChainLayout {
+        PackedGraphs graphs {};     // the bands there aren't are left 0
+        size_t numBands = 1;
+        bool operator==(const ChainLayout&) const = default;
+    };
+
+    enum class ReorderPhase
+    {
+        Idle,
+        FadingOut,
+        FadingIn
+    };
+
+    ChainLayout readLayout() const;
+    void updateLayout();
+    void applyLayout(const ChainLayout& layout);
+    void processChain(const juce::dsp::ProcessContextReplacing<float>& context);
+    void runChain(const juce::dsp::ProcessContextReplacing<float>& context);
 
+    ChainLayout appliedLayout { { DSP_Graph::fromOrder(defaultDSPOrder).pack() } };
+    ChainLayout pendingLayout = appliedLayout;
+    ReorderPhase reorderPhase = ReorderPhase::Idle;
+    juce::SmoothedValue<float> reorderFade;
+    bool bandsChangedSinceFade = false;     // every module is being prepared again
+    juce::AudioBuffer<float> reorderDryBuffer;
+
+    // out = dry + g * (out - dry), with g read from the smoother sample by sample.
+    void mixWithDry(const juce::dsp::AudioBlock<float>& block, const juce::AudioBuffer<float>& dryBuffer, juce::SmoothedValue<float>& wetGain);
+    std::vector<float> fadeGains;
+
+    // Outside prepareToPlay and releaseResources, only the audio thread
+    // touches dsp, and only while the lifetime says it is Ready.
     template<typename DSP>
     struct DSP_Choice: juce::dsp::ProcessorBase {
         void prepare(const juce::dsp::ProcessSpec& spec) override {
             dsp.prepare(spec);
+            dsp.reset();
+            numChannels = spec.numChannels;
+        }
+
+        // Ready, and prepared for at least this many channels.
+        bool canProcess(size_t numBlockChannels) const noexcept {
+            return lifetime.isReady() && numBlockChannels <= numChannels;
         }
 
         void process(const juce::dsp::ProcessContextReplacing<float>& context) override {
-            dsp.process(context);
+            if (canProcess(context.getOutputBlock().getNumChannels()))
+                dsp.process(context);
         }
 
         void reset() override {
-            dsp.reset();
+            if (lifetime.isReady())
+                dsp.reset();
+        }
+
+        // Frees every buffer, and the settings with them; prepare() starts over.
+        void release() {
+            dsp = DSP();
+            numChannels = 0;
         }
 
         DSP dsp;
+        ModuleLifetime lifetime;
+        size_t numChannels = 0;
     };
 
-    DSP_Choice<juce::dsp::DelayLine<float>> delay;
-    DSP_Choice<juce::dsp::Phaser<float>> phaser;
-    DSP_Choice<juce::dsp::Chorus<float>> chorus;
-    DSP_Choice<juce::dsp::LadderFilter<float>> overdrive, ladderFilter;
-    DSP_Choice<juce::dsp::IIR::Filter<float>> generalFilter;
+    // The pools are fixed in size; an instance's buffers are only allocated
+    // while it's in the graph and enabled, by prepareToPlay or the worker.
+    template<typename DSP>
+    using DSP_Pool = std::array<DSP_Choice<DSP>, instancesPerModule>;
+
+    DSP_Pool<MultiChannelPhaser> phaser;
+    DSP_Pool<MultiChannelChorus> chorus;
+    DSP_Pool<Overdrive> overdrive;
+    DSP_Pool<MultiChannelLadder> ladderFilter;
+    DSP_Pool<MultiChannelBiquad> generalFilter;
+    DSP_Pool<TempoDelay> delay;
+
+    using DSP_Pointers = std::array<juce::dsp::ProcessorBase*, maxChainSlots>;
+
+    void processChainWithPointers(const juce::dsp::ProcessContextReplacing<float>& context);
+    void processGraph(const juce::dsp::ProcessContextReplacing<float>& context);
+
+    // Band 0's slots are metered and timed where the editor draws them;
+    // instances only the other bands use are neither.
+    template<DSP_Option Option>
+    void processStep(std::optional<size_t> slot, size_t instance, const juce::dsp::ProcessContextReplacing<float>& context) {
+        if (slot.has_value())
+            processSlot<Option>(*slot, instance, context);
+        else
+            processModule<Option>(instance, context);
+    }
+
+    static constexpr size_t numDSPOptions = static_cast<size_t>(DSP_Option::END_OF_LIST);
+    static constexpr size_t numDSPOrders = ChainPermutations::factorial(numDSPOptions);
+
+    using ChainFunction = void (*)(JucetutorialsAudioProcessor&, const juce::dsp::ProcessContextReplacing<float>&);
+
+    template<typename Self, typename Function>
+    static void forEachModule(Self& self, Function&& function) {
+        for (size_t instance = 0; instance < instancesPerModule; ++instance) {
+            function(DSP_Option::Phase, instance, self.phaser[instance]);
+            function(DSP_Option::Chorus, instance, self.chorus[instance]);
+            function(DSP_Option::Overdrive, instance, self.overdrive[instance]);
+            function(DSP_Option::LadderFilter, instance, self.ladderFilter[instance]);
+            function(DSP_Option::GeneralFilter, instance, self.generalFilter[instance]);
+            function(DSP_Option::Delay, instance, self.delay[instance]);
+        }
+    }
+
+    template<DSP_Option Option>
+    auto& getModule(size_t instance) {
+        if constexpr (Option == DSP_Option::Phase)
+            return phaser[instance];
+        else if constexpr (Option == DSP_Option::Chorus)
+            return chorus[instance];
+        else if constexpr (Option == DSP_Option::Overdrive)
+            return overdrive[instance];
+        else if constexpr (Option == DSP_Option::LadderFilter)
+            return ladderFilter[instance];
+        else if constexpr (Option == DSP_Option::GeneralFilter)
+            return generalFilter[instance];
+        else if constexpr (Option == DSP_Option::Delay)
+            return delay[instance];
+        else
+            static_assert(Option != Option, "No module for this DSP_Option");
+    }
+
+    // Processes one module unless it is bypassed, crossfading while its bypass state changes.
+    template<DSP_Option Option>
+    void processModule(size_t instance, const juce::dsp::ProcessContextReplacing<float>& context);
+
+    template<DSP_Option Option>
+    void processSlot(size_t slot, size_t instance, const juce::dsp::ProcessContextReplacing<float>& context) {
+        {
+            ChainProfiler::ScopedTimer timer(profiler, ChainProfiler::getSlotStage(slot), static_cast<int>(Option));
+            processModule<Option>(instance, context);
+        }
+
+        meters[slot + 1].process(context.getOutputBlock(), processSpec.sampleRate);
+    }
+
+    // Runs the modules in the order of the given permutation, calling each
+    // concrete DSP directly so the whole chain can be inlined.
+    template<size_t OrderIndex, size_t... Slot>
+    static void processSlots(JucetutorialsAudioProcessor& p,
+                             const juce::dsp::ProcessContextReplacing<float>& context,
+                             std::index_sequence<Slot...>) {
+        constexpr auto& order = ChainPermutations::permutation<numDSPOptions, OrderIndex>;
+        (p.processSlot<static_cast<DSP_Option>(order[Slot])>(Slot, 0, context), ...);
+    }
+
+    template<size_t OrderIndex>
+    static void processOrder(JucetutorialsAudioProcessor& p, const juce::dsp::ProcessContextReplacing<float>& context) {
+        processSlots<OrderIndex>(p, context, std::make_index_sequence<numDSPOptions>());
+    }
+
+    template<size_t... OrderIndex>
+    static constexpr std::array<ChainFunction, sizeof...(OrderIndex)> makeChainFunctions(std::index_sequence<OrderIndex...>) {
+        return { &processOrder<OrderIndex>... };
+    }
+
+    // Returns the specialised chain for the order, or nullptr if the order repeats a module.
+    static ChainFunction getChainFunction(const DSP_Order& order);
+
+    ChainFunction chainFunction = getChainFunction(defaultDSPOrder);
+    ChainDispatch chainDispatch = ChainDispatch::Specialized;
+    std::atomic<int> minimumSubBlockSize { 64 };
+
+    // Per-module views of the parameters, read once per block and compared
+    // with the previous block so only modules whose inputs changed are touched.
+    struct PhaserSettings {
+        float rateHz = 0, centerFreqHz = 0, depth = 0, feedback = 0, mix = 0;
+        int channelPhases = 0;
+        bool operator==(const PhaserSettings&) const = default;
+    };
+
+    struct ChorusSettings {
+        float rateHz = 0, depth = 0, centerDelayMs = 0, feedback = 0, mix = 0;
+        int channelPhases = 0;
+        bool operator==(const ChorusSettings&) const = default;
+    };
+
+    struct OverdriveSettings {
+        float saturation = 0;
+        int kernel = 0, oversampling = 0;
+        bool operator==(const OverdriveSettings&) const = default;
+    };
+
+    struct LadderFilterSettings {
+        int mode = 0;
+        float cutoffHz = 0, resonance = 0, drive = 0;
+        bool operator==(const LadderFilterSettings&) const = default;
+    };
+
+    struct GeneralFilterSettings {
+        int mode = 0;
+        float freqHz = 0, quality = 0, gainDb = 0;
+        bool operator==(const GeneralFilterSettings&) const = default;
+    };
+
+    struct DelaySettings {
+        float timeMs = 0, feedback = 0, mix = 0, dampingHz = 0;
+        bool sync = false;
+        int note = 0, interpolation = 0;
+        double bpm = 120.0;     // host tempo, so a tempo change re-syncs the delay
+        bool operator==(const DelaySettings&) const = default;
+    };
+
+    struct ParameterSnapshot {
+        PhaserSettings phaser;
+        ChorusSettings chorus;
+        OverdriveSettings overdrive;
+        LadderFilterSettings ladderFilter;
+        GeneralFilterSettings generalFilter;
+        DelaySettings delay;
+        std::array<bool, numDSPOptions> bypassed {};
+
+        bool operator==(const ParameterSnapshot&) const = default;
+    };
+
+    using InstanceParameters = std::array<ParameterSnapshot, instancesPerModule>;
+    using GeneralFilterCoefficients = std::array<float, 6>;
+
+    ParameterSnapshot readParameters(size_t instance) const;
+    void updateDSPFromParameters(size_t instance,
+                                 const ParameterSnapshot& parameters,
+                                 int numSamples,
+                                 bool forceUpdate,
+                                 const GeneralFilterCoefficients* precomputedGeneralFilter = nullptr);
+
+    void updatePhaser(size_t instance, const PhaserSettings& settings);
+    void updateChorus(size_t instance, const ChorusSettings& settings);
+    void updateOverdrive(size_t instance, const OverdriveSettings& settings);
+    void updateLadderFilter(size_t instance, const LadderFilterSettings& settings);
+    static void configureLadderFilter(MultiChannelLadder& dsp, const LadderFilterSettings& settings, double sampleRate);
+    void updateGeneralFilterCoefficients(size_t instance);
+    std::uint32_t quantizeGeneralFilterSettings(GeneralFilterSettings& settings) const;
+    static GeneralFilterCoefficients makeGeneralFilterCoefficients(double sampleRate, const GeneralFilterSettings& settings);
+    void updateDelay(size_t instance, const DelaySettings& settings);
+    static double getDelaySeconds(const DelaySettings& settings);
+    static double getNoteBeats(int note);
+    void resetModule(DSP_Option option, size_t instance);
+
+    // The chain's latency only depends on the graphs and the overdrives'
+    // oversampling: a bypassed or unprepared overdrive delays its dry path as
+    // much as it would the signal. It's the slowest band's; the others are
+    // delayed to match before they're summed. The audio thread computes it,
+    // the message thread reports it to the host.
+    LatencyDelay* getDryDelay(DSP_Option option, size_t instance) noexcept;
+    void updateLatency();
+    void publishLatency();
+    void timerCallback() override;
+
+    std::atomic<int> chainLatency { 0 };
+    std::array<LatencyDelay, instancesPerModule> overdriveDryDelays;
+    std::array<LatencyDelay, maxBands> bandDelays;
+
+    // Audio thread: asks the worker for modules that were enabled or added
+    // to the graph, and gives back those bypassed or out of the graph for
+    // moduleReleaseSeconds. A module that has just been prepared takes its
+    // settings and fades in.
+    void updateModuleLifetimes(int numSamples);
+    bool areModulesReady() const;
+    void activateModule(DSP_Option option, size_t instance);
+    void serviceModules() override;
+
+    juce::CriticalSection moduleLock;           // held while preparing or releasing modules
+    juce::dsp::ProcessSpec moduleSpec { 44100.0, 512, 2 };  // what the worker prepares them for
+    std::atomic<bool> moduleRequestPending { false };
+
+    // What the processor keeps for each instance: instance i of every module
+    // follows moduleParameters[i]. Only instance 0 is modulated and ramped
+    // across sub-blocks; the others take their parameters once per block,
+    // but their smoothers are stepped on the same sub-blocks.
+    struct InstanceState {
+        ParameterSnapshot lastParameters;
+
+        // Wet gain per DSP_Option: 0 means bypassed and not processed at all.
+        std::array<juce::SmoothedValue<float>, numDSPOptions> bypassFades;
+
+        std::array<std::uint32_t, numDSPOptions> bands {};  // running the instance in the applied schedule, if any
+        std::array<bool, numDSPOptions> moduleActive {};   // Ready and set up
+        std::array<juce::int64, numDSPOptions> moduleIdleSamples {};
+
+        // The JUCE phaser, chorus and ladder smooth their own inputs; the IIR
+        // coefficients are stepped at control rate from these smoothers instead.
+        juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> generalFilterFreqSmoother;
+        juce::SmoothedValue<float> generalFilterQualitySmoother, generalFilterGainSmoother;
+        bool generalFilterModeChanged = false;
+    };
+
+    juce::dsp::ProcessSpec processSpec { 44100.0, 512, 2 };
+    std::array<InstanceState, instancesPerModule> instances;
+    ParameterSnapshot lastHostParameters;   // instance 0 unmodulated, where the next automation ramp starts
+
+    // Coefficients for the parameters' own steps at the current sample rate,
+    // so a ramp that revisits a setting skips the trig. Audio thread only.
+    CoefficientCache<GeneralFilterCoefficients> generalFilterCache;
+
+    // Last tempo reported by the host; kept when the play head has none.
+    double hostBpm = 120.0;
+    juce::Optional<double> hostPpqPosition;     // only while the host is playing
+    void updateHostTempo();
+
+    // Sources are rendered for the whole block at control-rate ticks; the
+    // block is then processed tick by tick with the modulated parameters,
+    // so modules only see new settings, and recompute coefficients, on ticks.
+    struct ModulationRoute {
+        ModulationSource source = ModulationSource::None;
+        size_t target = 0;
+        float depth = 0;    // in normalised parameter range, bipolar
+    };
+
+    struct ModulationSettings {
+        std::array<ModulationRoute, numModulationSlots> routes;
+        size_t controlRate = 32;
+        bool isActive = false;
+        bool modulatesGeneralFilter = false;
+    };
+
+    ModulationSettings readModulation();
+    // Processes the block in sub-blocks, ramping instance 0's continuous
+    // parameters from one snapshot to the other and applying modulation on
+    // each segment. The other instances take theirs from others, unramped.
+    void processSegmented(const juce::dsp::AudioBlock<float>& block,
+                          const ParameterSnapshot& from,
+                          const ParameterSnapshot& to,
+                          const InstanceParameters& others,
+                          const ModulationSettings& modulation);
+
+    // The float settings of every module by index, which is also the modulation target index.
+    static constexpr size_t numFloatSettings = 21;
+    static float& getFloatSetting(ParameterSnapshot& parameters, size_t index);
+    static float getFloatSetting(const ParameterSnapshot& parameters, size_t index) { return getFloatSetting(const_cast<ParameterSnapshot&>(parameters), index); }
+    static bool haveFloatSettingsChanged(const ParameterSnapshot& a, const ParameterSnapshot& b);
+
+    std::array<Lfo, numLfos> lfos;
+    EnvelopeFollower envelopeFollower;
+    std::array<std::vector<float>, numLfos> lfoTicks;
+    std::vector<float> envelopeTicks;
+    std::vector<juce::AudioParameterFloat*> modulationTargets;
+
+    // The general filter's smoothers would blur fast modulation, so they jump while it's modulated.
+    bool generalFilterModulated = false;
+
+    // Silence below -100 dB puts the chain to sleep once every tail has decayed.
+    static constexpr float silenceThreshold = 1.0e-5f;
+    static constexpr double maxTailSeconds = 30.0;
+
+    static bool isSilent(const juce::AudioBuffer<float>& buffer, int numChannels);
+
+    // Returns true when the chain should run on the first channel only.
+    // parameters are instance 0's for this block.
+    bool updateMonoCollapse(const juce::AudioBuffer<float>& buffer, int numChannels, const ParameterSnapshot& parameters);
+    static bool areChannelsIdentical(const juce::AudioBuffer<float>& buffer, int numChannels);
+    static void fadeFromFirstChannel(const juce::dsp::AudioBlock<float>& block);
+    static double getTailSeconds(const ParameterSnapshot& parameters, DSP_Option option);
+    void updateTail();
+    void resetAllModules();
+    // Going to sleep: clears the filters' and LFOs' state but not the delay
+    // lines, which only hold what is already below silenceThreshold and
+    // would take seconds of samples to write in one callback.
+    void resetModulesForSleep();
+
+    std::atomic<double> tailLengthSeconds { 0.0 };
+    juce::int64 tailLengthSamples = 0;
+    juce::int64 silentInputSamples = 0;
+    juce::int64 identicalInputSamples = 0;
+    bool wasCollapsed = false;
+    bool chainIsAsleep = false;
+
+    juce::AudioBuffer<float> bypassDryBuffer;
+
+    // Split mode. The modules are prepared for numBands times the bus's
+    // channels: on a change of band count, the worker prepares them again
+    // while the chain is faded out.
+    void updateCrossovers();
+    void processBands(const juce::dsp::ProcessContextReplacing<float>& context);
+
+    CrossoverSplitter splitter;
+    juce::AudioBuffer<float> bandBuffer;
+    std::atomic<juce::uint32> moduleBands { 1 };     // what the worker prepares modules for
+
+    std::array<LevelMeter, numMeters> meters;
+    SpectrumTap preChainTap, postChainTap;
+
+    // What the filter response was last computed from. The ladder here is
+    // configured like each ladderFilter in turn but never processes, only evaluates.
+    struct FilterResponseInputs {
+        std::array<LadderFilterSettings, instancesPerModule> ladderFilter;
+        std::array<GeneralFilterSettings, instancesPerModule> generalFilter;
+        std::array<bool, instancesPerModule> ladderFilterBypassed {}, generalFilterBypassed {};
+        std::uint64_t packedGraph = 0;
+        double sampleRate = 0;
+        bool operator==(const FilterResponseInputs&) const = default;
+    };
+
+    std::optional<FilterResponseInputs> filterResponseInputs;
+    FilterResponse filterResponse;
+    MultiChannelLadder responseLadder;
+
+    ChainProfiler profiler;
+
+    // Factory programs, decoded once on the module worker: every parameter
+    // value plus the graphs, with the first general filter already designed.
+    struct Program {
+        std::vector<float> values;      // normalised, in getParameters() order
+        PackedGraphs packedGraphs {};   // the preset's order, followed by every band
+        GeneralFilterSettings generalFilter;
+        double sampleRate = 0;
+        GeneralFilterCoefficients generalFilterCoefficients {};
+    };
+
+    // The worker decodes the programs soon after construction. Whatever needs
+    // them first decodes them itself if it hasn't yet, which takes
+    // microseconds, rather than waiting for the worker to get round to it.
+    void ensureProgramsDecoded(double sampleRate);
+    void decodePrograms(double sampleRate);
+    void updateProgramCoefficients(Program& program, double sampleRate) const;
+    static bool isValidOrder(std::uint32_t packedOrder);
+
+    std::vector<Program> programs;
+    juce::CriticalSection programsLock;     // held while decoding
+    std::atomic<bool> programsDecoded { false };
+    juce::StringArray programNames;
+    int currentProgram = 0;
+
+    // Loading a program or a saved state: the message thread bumps
+    // reloadRequests, writes the parameters and graphs, publishes
+    // the program and marks the request ready. The audio thread fades the
+    // chain out meanwhile, stops following the parameters, and reloads
+    // everything at once when it's dry and the request is complete.
+    void loadParameterValues(const std::vector<float>& values, const PackedGraphs& packed, const Program* program);
+    void updateReload(int numSamples);
+    bool isReloadPending() const { return reloadRequests.load() != appliedReload; }
+    bool tryReload(int numSamples);
+
+    std::atomic<const Program*> pendingProgram { nullptr };
+    std::atomic<std::uint32_t> reloadRequests { 0 }, reloadsReady { 0 };
+    std::uint32_t appliedReload = 0;
+
+    // Binary state: magic, version, one packed graph per band, current
+    // program, then one (paramID, normalised value) pair per parameter.
+    // Version 1 saved a 32-bit PackedOrder instead of the graph, versions 2
+    // to 4 one graph for every band, which 3 and 4 followed by band skips,
+    // and versions before 4 saved the hash of each ID.
+    static constexpr int stateMagic = 0x4a545354;     // "JTST"
+    static constexpr short stateVersion = 5;
+    std::vector<int> parameterIDHashes;
 
-    using DSP_Pointers = std::array<juce::dsp::ProcessorBase*, static_cast<size_t>(DSP_Option::END_OF_LIST)>;
+    // Removing the client in the destructor also stops the decoding job
+    // before the members it uses are destroyed.
+    juce::SharedResourcePointer<ModuleWorker> moduleWorker;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JucetutorialsAudioProcessor)
@@ -0,0 +1,223 @@
+/*
+  ==============================================================================
+
+    Pre- and post-chain spectrum display for the editor.
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyzer.h"
+
+SpectrumAnalyzer::SpectrumAnalyzer(SpectrumTap& preChainTap, SpectrumTap& postChainTap)
+    : window(static_cast<size_t>(fftSize)),
+      fftData(static_cast<size_t>(fftSize) * 2),
+      traces { Trace(preChainTap), Trace(postChainTap) } {
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(fftSize),
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+
+    for (auto& trace : traces) {
+        trace.levelsDb.fill(floorDb);
+        trace.path.preallocateSpace(numBands * 3 + 3);
+        trace.tap.attachReader();
+    }
+
+    responsePath.preallocateSpace(static_cast<int>(FilterResponse::numPoints) * 3 + 3);
+    setOpaque(true);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    for (auto& trace : traces)
+        trace.tap.detachReader();
+}
+
+void SpectrumAnalyzer::setFilterResponse(const FilterResponse& response) {
+    responseMagnitudes = response.getMagnitudes();
+    responseTopFrequency = response.getTopFrequency();
+    hasResponse = true;
+
+    updateResponsePath();
+    repaint();
+}
+
+void SpectrumAnalyzer::paint(juce::Graphics& g) {
+    auto bounds = getLocalBounds().toFloat();
+    g.fillAll(juce::Colours::black);
+
+    // Decade lines at 100 Hz, 1 kHz and 10 kHz.
+    g.setColour(juce::Colours::darkgrey);
+
+    for (auto frequency : { 100.f, 1000.f, 10000.f }) {
+        if (frequency >= topFrequency)
+            continue;
+
+        auto x = bounds.getX() + bounds.getWidth() * juce::mapFromLog10(frequency, minFrequency, topFrequency);
+        g.drawVerticalLine(juce::roundToInt(x), bounds.getY(), bounds.getBottom());
+    }
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.strokePath(traces[0].path, juce::PathStrokeType(1.f));
+
+    g.setColour(juce::Colours::green);
+    g.strokePath(traces[1].path, juce::PathStrokeType(1.5f));
+
+    if (hasResponse) {
+        g.setColour(juce::Colours::yellow);
+        g.strokePath(responsePath, juce::PathStrokeType(1.5f));
+    }
+}
+
+void SpectrumAnalyzer::resized() {
+    for (auto& trace : traces)
+        updatePath(trace);
+
+    updateResponsePath();
+}
+
+void SpectrumAnalyzer::update() {
+    auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    auto elapsedSeconds = juce::jlimit(0.0, 0.5, (nowMs - lastUpdateMs) / 1000.0);
+    lastUpdateMs = nowMs;
+
+    // Hidden editors leave the taps to fill up, which costs the audio thread nothing.
+    if (! isShowing())
+        return;
+
+    auto sampleRate = traces[1].tap.getSampleRate();
+
+    if (sampleRate != bandSampleRate)
+        updateBands(sampleRate);
+
+    auto releaseDb = static_cast<float>(releaseDbPerSecond * elapsedSeconds);
+    auto changed = false;
+
+    for (auto& trace : traces) {
+        if (readTap(trace))
+            analyse(trace, releaseDb);
+        else if (! release(trace, releaseDb))
+            continue;
+
+        updatePath(trace);
+        changed = true;
+    }
+
+    if (changed)
+        repaint();
+}
+
+bool SpectrumAnalyzer::readTap(Trace& trace) {
+    auto numRead = trace.tap.read([&](const float* samples, int numSamples) {
+        // Only the last fftSize samples can matter.
+        auto skip = juce::jmax(0, numSamples - fftSize);
+        samples += skip;
+        numSamples -= skip;
+
+        while (numSamples > 0) {
+            auto num = juce::jmin(numSamples, fftSize - trace.historyPosition);
+            std::copy_n(samples, num, trace.history.data() + trace.historyPosition);
+            trace.historyPosition = (trace.historyPosition + num) % fftSize;
+            samples += num;
+            numSamples -= num;
+        }
+    });
+
+    return numRead > 0;
+}
+
+void SpectrumAnalyzer::analyse(Trace& trace, float releaseDb) {
+    // Unroll the history oldest first, then window it.
+    auto oldest = static_cast<size_t>(trace.historyPosition);
+    auto* data = fftData.data();
+    std::copy(trace.history.begin() + static_cast<std::ptrdiff_t>(oldest), trace.history.end(), data);
+    std::copy_n(trace.history.begin(), oldest, data + (fftSize - trace.historyPosition));
+    juce::FloatVectorOperations::multiply(data, window.data(), fftSize);
+
+    fft.performFrequencyOnlyForwardTransform(data, true);
+
+    // A full-scale sine through a Hann window peaks at fftSize / 4.
+    juce::FloatVectorOperations::multiply(data, 4.f / static_cast<float>(fftSize), fftSize / 2 + 1);
+
+    for (size_t band = 0; band < numBands; ++band) {
+        auto [first, last] = bandBins[band];
+        auto magnitude = juce::FloatVectorOperations::findMaximum(data + first, last - first + 1);
+        auto db = juce::Decibels::gainToDecibels(magnitude, floorDb);
+
+        // Instant attack, linear release in dB.
+        trace.levelsDb[band] = juce::jmax(db, trace.levelsDb[band] - releaseDb);
+    }
+}
+
+bool SpectrumAnalyzer::release(Trace& trace, float releaseDb) {
+    auto falling = false;
+
+    for (auto& levelDb : trace.levelsDb) {
+        falling |= levelDb > floorDb;
+        levelDb = juce::jmax(floorDb, levelDb - releaseDb);
+    }
+
+    return falling;
+}
+
+void SpectrumAnalyzer::updateBands(double sampleRate) {
+    bandSampleRate = sampleRate;
+    topFrequency = juce::jmin(maxFrequency, static_cast<float>(sampleRate * 0.5));
+
+    auto binHz = sampleRate / fftSize;
+    auto lastBin = fftSize / 2;
+
+    for (size_t band = 0; band < numBands; ++band) {
+        auto lowHz = juce::mapToLog10(static_cast<float>(band) / numBands, minFrequency, topFrequency);
+        auto highHz = juce::mapToLog10(static_cast<float>(band + 1) / numBands, minFrequency, topFrequency);
+
+        // Low bands narrower than a bin share the nearest one.
+        auto first = juce::jlimit(0, lastBin, juce::roundToInt(lowHz / binHz));
+        auto last = juce::jlimit(first, lastBin, juce::roundToInt(highHz / binHz) - 1);
+        bandBins[band] = { first, last };
+    }
+
+    for (auto& trace : traces)
+        trace.levelsDb.fill(floorDb);
+
+    updateResponsePath();
+}
+
+void SpectrumAnalyzer::updatePath(Trace& trace) {
+    auto bounds = getLocalBounds().toFloat();
+    auto& path = trace.path;
+
+    // Clearing keeps the path's storage, so redrawing doesn't allocate.
+    path.clear();
+
+    for (size_t band = 0; band < numBands; ++band) {
+        auto x = bounds.getX() + bounds.getWidth() * (static_cast<float>(band) + 0.5f) / numBands;
+        auto y = juce::jmap(trace.levelsDb[band], floorDb, 0.f, bounds.getBottom(), bounds.getY());
+
+        if (band == 0)
+            path.startNewSubPath(x, y);
+        else
+            path.lineTo(x, y);
+    }
+}
+
+void SpectrumAnalyzer::updateResponsePath() {
+    auto bounds = getLocalBounds().toFloat();
+    responsePath.clear();
+
+    if (! hasResponse)
+        return;
+
+    // The response's grid ends at its own top frequency, which matches the
+    // spectrum's once both have seen the same sample rate.
+    auto widthScale = juce::mapFromLog10(responseTopFrequency, minFrequency, topFrequency);
+
+    for (size_t i = 0; i < FilterResponse::numPoints; ++i) {
+        auto position = static_cast<float>(i) / static_cast<float>(FilterResponse::numPoints - 1) * widthScale;
+        auto x = bounds.getX() + bounds.getWidth() * position;
+        auto db = juce::jlimit(-responseRangeDb, responseRangeDb, juce::Decibels::gainToDecibels(responseMagnitudes[i], -responseRangeDb));
+        auto y = juce::jmap(db, -responseRangeDb, responseRangeDb, bounds.getBottom(), bounds.getY());
+
+        if (i == 0)
+            responsePath.startNewSubPath(x, y);
+        else
+            responsePath.lineTo(x, y);
+    }
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    Pre- and post-chain spectrum display for the editor.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DSP/SpectrumTap.h"
+#include "DSP/FilterResponse.h"
+
+/** Draws the spectrum of the chain's input and output, and over it the
+    response of the chain's filters.
+
+    All the analysis runs on the message thread, once per display refresh
+    and only when a tap delivered new samples; without any, as while the
+    chain sleeps, the traces only fall. The latest window is
+    Hann-windowed with vector operations, transformed, and reduced to
+    log-spaced bands. The band-to-FFT-bin ranges are worked out once per
+    sample rate, and the paths keep their storage between frames.
+*/
+class SpectrumAnalyzer  : public juce::Component
+{
+public:
+    SpectrumAnalyzer(SpectrumTap& preChainTap, SpectrumTap& postChainTap);
+    ~SpectrumAnalyzer() override;
+
+    /** Copies the response, which is then drawn until the next call. */
+    void setFilterResponse(const FilterResponse& response);
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr int fftOrder = SpectrumTap::windowOrder;
+    static constexpr int fftSize = SpectrumTap::windowSize;
+    static constexpr int numBands = 96;
+    static constexpr float minFrequency = 20.f, maxFrequency = 20000.f;
+    static constexpr float floorDb = -90.f;
+    static constexpr float releaseDbPerSecond = 60.f;
+
+    struct Trace {
+        explicit Trace(SpectrumTap& t) : tap(t) {}
+
+        SpectrumTap& tap;
+        std::vector<float> history = std::vector<float>(static_cast<size_t>(fftSize));    // circular, the latest window
+        int historyPosition = 0;
+        std::array<float, numBands> levelsDb;
+        juce::Path path;
+    };
+
+    void update();
+    bool readTap(Trace& trace);
+    void analyse(Trace& trace, float releaseDb);
+    bool release(Trace& trace, float releaseDb);
+    void updateBands(double sampleRate);
+    void updatePath(Trace& trace);
+    void updateResponsePath();
+
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window, fftData;
+
+    // Each band is the loudest FFT bin in [first, last].
+    std::array<std::pair<int, int>, numBands> bandBins {};
+    double bandSampleRate = 0;
+    float topFrequency = maxFrequency;
+
+    std::array<Trace, 2> traces;
+
+    // Drawn with 0 dB halfway up and responseRangeDb to either edge.
+    static constexpr float responseRangeDb = 30.f;
+    std::array<float, FilterResponse::numPoints> responseMagnitudes {};
+    float responseTopFrequency = maxFrequency;
+    bool hasResponse = false;
+    juce::Path responsePath;
+    double lastUpdateMs = 0;
+
+    juce::VBlankAttachment vBlankAttachment { this, [this] { update(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyzer)
+};